@@ -1,8 +1,11 @@
 #version 400 core
 layout (location = 0) in vec3 aPos;
 
-uniform mat4 projection;
-uniform mat4 view;
+layout (std140) uniform FrameBlock {
+	mat4 view;
+	mat4 projection;
+	vec3 camPos;
+};
 
 out vec3 WorldPos;
 
@@ -4,11 +4,14 @@ out vec4 FragColor;
 in vec2 TexCoords;
 in vec3 WorldPos;
 in vec3 Normal;
+flat in vec4 InstanceParams;
 
 uniform vec3 lightPosition;
 uniform vec3 lightColor;
+// instanced lights carry their color in InstanceParams
+uniform bool instanced;
 
 void main()
 {
-	FragColor = vec4(lightColor, 1.f);
+	FragColor = vec4(instanced ? InstanceParams.rgb : lightColor, 1.f);
 }
\ No newline at end of file
@@ -4,35 +4,50 @@ out vec4 FragColor;
 in vec2 TexCoords;
 in vec3 WorldPos;
 in vec3 Normal;
-
-uniform sampler2D albedoMap;
-uniform sampler2D normalMap;
-uniform sampler2D metallicMap;
-uniform sampler2D roughnessMap;
-uniform sampler2D aoMap;
-
-uniform float roughness_val;
-uniform bool roughness_status;
-uniform float metallic_val;
-uniform bool metallic_status;
+flat in vec4 InstanceParams;
+
+// one layer per material, picked by material or per instance by InstanceParams.z
+uniform sampler2DArray albedoMap;
+uniform sampler2DArray normalMap;
+// ao, roughness and metallic in r, g and b
+uniform sampler2DArray ormMap;
+uniform int material;
+uniform bool instanced;
+
+layout (std140) uniform MaterialBlock {
+	float metallic_val;
+	float roughness_val;
+	bool metallic_status;
+	bool roughness_status;
+};
+// metallic and roughness come per instance in InstanceParams instead of the _val uniforms
+uniform bool instance_material;
 
 // IBL
 uniform samplerCube irradianceMap;
 uniform samplerCube prefilterMap;
 uniform sampler2D brdfLUT;
 
-uniform vec3 lightPositions[20];
-uniform vec3 lightColors[20];
+layout (std140) uniform LightsBlock {
+	vec3 lightPositions[20];
+	vec3 lightColors[20];
+	int light_num;
+};
 
-uniform vec3 camPos;
-uniform int light_num;
+layout (std140) uniform FrameBlock {
+	mat4 view;
+	mat4 projection;
+	vec3 camPos;
+};
 
 const float PI = 3.14159265359;
 #define TWOPI  6.283185308
 
-vec3 getNormalFromMap()
+vec3 getNormalFromMap(float layer)
 {
-    vec3 tangentNormal = texture(normalMap, TexCoords).xyz * 2.0 - 1.0;
+    // the normal arrays keep x and y only, z is rebuilt from unit length
+    vec2 xy = texture(normalMap, vec3(TexCoords, layer)).rg * 2.0 - 1.0;
+    vec3 tangentNormal = vec3(xy, sqrt(max(1.0 - dot(xy, xy), 0.0)));
 
     vec3 Q1  = dFdx(WorldPos);
     vec3 Q2  = dFdy(WorldPos);
@@ -98,16 +113,18 @@ vec2 Projection(vec3 pos)
 }
 void main()
 {
-    vec3 albedo     = pow(texture(albedoMap, TexCoords).rgb, vec3(2.2));
-    float metallic  = texture(metallicMap, TexCoords).r;
-    float roughness = texture(roughnessMap, TexCoords).r;
-    float ao        = texture(aoMap, TexCoords).r;
+    float layer     = instanced ? InstanceParams.z : float(material);
+    vec3 albedo     = pow(texture(albedoMap, vec3(TexCoords, layer)).rgb, vec3(2.2));
+    vec3 orm        = texture(ormMap, vec3(TexCoords, layer)).rgb;
+    float metallic  = orm.b;
+    float roughness = orm.g;
+    float ao        = orm.r;
     if(roughness_status)
-        roughness = roughness_val;
+        roughness = instance_material ? InstanceParams.y : roughness_val;
     if(metallic_status)
-        metallic = metallic_val;
+        metallic = instance_material ? InstanceParams.x : metallic_val;
 
-    vec3 N = getNormalFromMap();
+    vec3 N = getNormalFromMap(layer);
     vec3 V = normalize(camPos - WorldPos);
     vec3 R = reflect(-V,N);//2 * dot(V, N) * N - V;
 
@@ -2,19 +2,42 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoord;
 layout (location = 2) in vec3 aNormal;
+layout (location = 3) in vec2 aOctNormal;
+// per instance, read instead of model when instanced is set
+layout (location = 4) in mat4 aInstanceModel;
+layout (location = 8) in vec4 aInstanceParams;
 
 out vec2 TexCoords; 
 out vec3 WorldPos;
 out vec3 Normal;
+flat out vec4 InstanceParams;
 	
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+// UniformBlocks, set once per frame
+layout (std140) uniform FrameBlock {
+	mat4 view;
+	mat4 projection;
+	vec3 camPos;
+};
+// set for packed objects, their normals come octahedral encoded in aOctNormal
+uniform bool octahedral_normals;
+uniform bool instanced;
+
+vec3 OctDecode(vec2 e)
+{
+	vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	float t = max(-n.z, 0.0);
+	n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+	return normalize(n);
+}
 
 void main()
 {
-	WorldPos = vec3(model * vec4(aPos, 1.0));
-	Normal = mat3(transpose(inverse(model))) * aNormal;
+	mat4 world = instanced ? aInstanceModel : model;
+	WorldPos = vec3(world * vec4(aPos, 1.0));
+	vec3 normal = octahedral_normals ? OctDecode(aOctNormal) : aNormal;
+	Normal = mat3(transpose(inverse(world))) * normal;
 	TexCoords = aTexCoord;
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+	InstanceParams = aInstanceParams;
+    gl_Position = projection * view * world * vec4(aPos, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,50 @@
+#version 430 core
+layout (local_size_x = 128) in;
+
+// same layout as GpuCollider in GpuSoftBody.h
+struct Collider {
+	vec4 sphere;	// center, radius
+	vec4 plane;		// normal, d
+	vec4 box_min;	// bounds of the plane's point0 / point1
+	vec4 box_max;
+	int kind;
+};
+
+layout (std430, binding = 0) buffer Positions { vec4 pos[]; };
+layout (std430, binding = 5) readonly buffer Colliders { Collider colliders[]; };
+
+uniform int count;
+uniform int collider_count;
+uniform float contact_depth;
+
+void main()
+{
+	int i = int(gl_GlobalInvocationID.x);
+	if (i >= count)
+		return;
+	// the colliders push the particle one after another, like CollisionResponseRigid called for each of them
+	vec3 point = pos[i].xyz;
+	for (int c = 0; c < collider_count; ++c)
+	{
+		if (colliders[c].kind == 0)
+		{
+			vec3 center = colliders[c].sphere.xyz;
+			float radius = colliders[c].sphere.w;
+			vec3 offset = center - point;
+			if (dot(offset, offset) < radius * radius)
+				point = center + normalize(point - center) * radius;
+		}
+		else
+		{
+			vec3 norm = colliders[c].plane.xyz;
+			float dist = dot(point, norm) + colliders[c].plane.w;
+			if (abs(dist) < contact_depth && dist < 0.0)
+			{
+				vec3 moved = point - dist * norm;
+				if (all(greaterThanEqual(moved, colliders[c].box_min.xyz)) && all(lessThanEqual(moved, colliders[c].box_max.xyz)))
+					point = moved;
+			}
+		}
+	}
+	pos[i].xyz = point;
+}
@@ -0,0 +1,36 @@
+#version 430 core
+layout (local_size_x = 128) in;
+
+// same layout as constraints in Base.h
+struct Distance {
+	int p1;
+	int p2;
+	float restlen;
+};
+
+layout (std430, binding = 0) buffer Positions { vec4 pos[]; };
+layout (std430, binding = 2) readonly buffer Distances { Distance cons[]; };
+
+// one color batch: its constraints share no particle
+uniform int first;
+uniform int count;
+// stiffness * dt * KEEP_CONS_SPEED
+uniform float factor;
+
+void main()
+{
+	int j = int(gl_GlobalInvocationID.x);
+	if (j >= count)
+		return;
+	Distance c = cons[first + j];
+	vec3 delta = pos[c.p2].xyz - pos[c.p1].xyz;
+	if (delta == vec3(0.0))
+		return;
+
+	float len = sqrt(delta.x * delta.x + delta.y * delta.y + delta.z * delta.z);
+	float diff = (len - c.restlen) / len;
+	vec3 force = factor * delta * diff;
+
+	pos[c.p1].xyz += force;
+	pos[c.p2].xyz -= force;
+}
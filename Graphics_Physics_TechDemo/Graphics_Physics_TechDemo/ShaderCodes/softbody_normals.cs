@@ -0,0 +1,41 @@
+#version 430 core
+layout (local_size_x = 128) in;
+
+layout (std430, binding = 0) readonly buffer Vertices { float vertices[]; };
+layout (std430, binding = 1) buffer Normals { float normals[]; };
+// the adjacency Object::BuildNormalAdjacency builds
+layout (std430, binding = 2) readonly buffer Faces { int faces[]; };
+layout (std430, binding = 3) readonly buffer FaceStart { int face_start[]; };
+layout (std430, binding = 4) readonly buffer VertexFaces { int vertex_faces[]; };
+layout (std430, binding = 5) readonly buffer Weld { int weld[]; };
+
+uniform int count;
+
+vec3 Vertex(int i)
+{
+	return vec3(vertices[3 * i], vertices[3 * i + 1], vertices[3 * i + 2]);
+}
+
+void main()
+{
+	int v = int(gl_GlobalInvocationID.x);
+	if (v >= count)
+		return;
+	int w = weld[v];
+	vec3 sum = vec3(0.0);
+	for (int k = face_start[w]; k < face_start[w + 1]; ++k)
+	{
+		int f = vertex_faces[k];
+		vec3 p0 = Vertex(faces[3 * f]);
+		sum += cross(Vertex(faces[3 * f + 1]) - p0, Vertex(faces[3 * f + 2]) - p0);
+	}
+	float len = length(sum);
+	// a vertex with only degenerate faces keeps the normal it had
+	if (len > 0.0)
+	{
+		vec3 n = sum / len;
+		normals[3 * v] = n.x;
+		normals[3 * v + 1] = n.y;
+		normals[3 * v + 2] = n.z;
+	}
+}
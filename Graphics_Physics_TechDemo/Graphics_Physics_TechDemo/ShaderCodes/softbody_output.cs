@@ -0,0 +1,24 @@
+#version 430 core
+layout (local_size_x = 128) in;
+
+layout (std430, binding = 0) readonly buffer Positions { vec4 pos[]; };
+layout (std430, binding = 1) readonly buffer OldPositions { vec4 old[]; };
+// the render VBO, tightly packed vec3
+layout (std430, binding = 2) writeonly buffer Vertices { float vertices[]; };
+
+uniform int count;
+uniform float alpha;
+uniform vec3 position;
+uniform vec3 scale;
+
+void main()
+{
+	int i = int(gl_GlobalInvocationID.x);
+	if (i >= count)
+		return;
+	vec3 point = (1.0 - alpha) * old[i].xyz + alpha * pos[i].xyz;
+	vec3 vertex = (point - position) / scale;
+	vertices[3 * i] = vertex.x;
+	vertices[3 * i + 1] = vertex.y;
+	vertices[3 * i + 2] = vertex.z;
+}
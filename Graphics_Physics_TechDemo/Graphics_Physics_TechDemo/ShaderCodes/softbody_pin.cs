@@ -0,0 +1,20 @@
+#version 430 core
+layout (local_size_x = 128) in;
+
+struct Pin {
+	vec3 position;
+	int index;
+};
+
+layout (std430, binding = 0) buffer Positions { vec4 pos[]; };
+layout (std430, binding = 4) readonly buffer Pins { Pin pins[]; };
+
+uniform int count;
+
+void main()
+{
+	int i = int(gl_GlobalInvocationID.x);
+	if (i >= count)
+		return;
+	pos[pins[i].index].xyz = pins[i].position;
+}
@@ -0,0 +1,20 @@
+#version 430 core
+layout (local_size_x = 128) in;
+
+layout (std430, binding = 0) buffer Positions { vec4 pos[]; };
+layout (std430, binding = 1) buffer OldPositions { vec4 old[]; };
+
+uniform int count;
+uniform float dt;
+uniform float damping;
+uniform vec3 acceleration;
+
+void main()
+{
+	int i = int(gl_GlobalInvocationID.x);
+	if (i >= count)
+		return;
+	vec3 temp = pos[i].xyz;
+	pos[i].xyz += damping * temp - damping * old[i].xyz + acceleration * dt * dt;
+	old[i].xyz = temp;
+}
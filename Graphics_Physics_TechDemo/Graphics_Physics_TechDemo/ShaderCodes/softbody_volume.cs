@@ -0,0 +1,45 @@
+#version 430 core
+layout (local_size_x = 128) in;
+
+// same layout as volume_constraints in Base.h
+struct Volume {
+	int p1;
+	int p2;
+	int p3;
+	int p4;
+	float restlen1;
+	float restlen2;
+};
+
+layout (std430, binding = 0) buffer Positions { vec4 pos[]; };
+layout (std430, binding = 3) readonly buffer Volumes { Volume cons[]; };
+
+uniform int first;
+uniform int count;
+uniform float factor;
+
+void main()
+{
+	int j = int(gl_GlobalInvocationID.x);
+	if (j >= count)
+		return;
+	Volume c = cons[first + j];
+	vec3 point1 = pos[c.p1].xyz;
+	vec3 point2 = pos[c.p2].xyz;
+	vec3 point3 = pos[c.p3].xyz;
+	vec3 point4 = pos[c.p4].xyz;
+
+	vec3 delta1 = point2 - point1;
+	vec3 delta2 = point4 - point3;
+
+	float len = distance(point2, point1) + distance(point4, point3);
+	float diff = (len - c.restlen1 - c.restlen2) / len;
+
+	vec3 force1 = factor * delta1 * diff * 0.5;
+	pos[c.p1].xyz += force1;
+	pos[c.p2].xyz -= force1;
+
+	vec3 force2 = factor * delta2 * diff * 0.5;
+	pos[c.p3].xyz += force2;
+	pos[c.p4].xyz -= force2;
+}
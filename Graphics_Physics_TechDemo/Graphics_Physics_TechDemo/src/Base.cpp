@@ -11,34 +11,105 @@ Author: Nahye Park, nahye.park
 Creation date: 9/20/2018
 End Header --------------------------------------------------------*/
 #include "Base.h"
+#include "GpuSoftBody.h"
+#include "ParticleKernels.h"
+#include "ThreadPool.h"
 #include <iostream>
+#include <algorithm>
 
 #define KEEP_CONS_SPEED 35.f
+// color batches smaller than this are solved on the calling thread
+#define PARALLEL_MIN_BATCH 512
+// half size of the box queried around a vertex in the triangle tree
+#define TREE_QUERY_SLACK 0.1f
+
+namespace
+{
+	// greedy graph coloring: the first color none of the particles is used in yet
+	unsigned FirstFreeColor(std::vector<std::vector<char>>& used, const int* particles, unsigned count, unsigned ver)
+	{
+		unsigned color = 0;
+		for (; color < used.size(); ++color)
+		{
+			bool free = true;
+			for (unsigned k = 0; k < count && free; ++k)
+				free = !used[color][particles[k]];
+			if (free)
+				break;
+		}
+		if (color == used.size())
+			used.push_back(std::vector<char>(ver, 0));
+		for (unsigned k = 0; k < count; ++k)
+			used[color][particles[k]] = 1;
+		return color;
+	}
+
+	// stable counting sort by color, batches[c] is where color c starts
+	template <typename T>
+	void GroupByColor(const std::vector<T>& cons, const std::vector<unsigned>& color, unsigned color_count,
+		std::vector<T>& flat, std::vector<unsigned>& batches)
+	{
+		batches.assign(color_count + 1, 0);
+		for (unsigned j = 0; j < cons.size(); ++j)
+			++batches[color[j] + 1];
+		for (unsigned c = 0; c < color_count; ++c)
+			batches[c + 1] += batches[c];
+
+		std::vector<unsigned> cursor(batches.begin(), batches.end() - 1);
+		flat.resize(cons.size());
+		for (unsigned j = 0; j < cons.size(); ++j)
+			flat[cursor[color[j]]++] = cons[j];
+	}
+
+	unsigned SpreadBits(unsigned v)
+	{
+		v &= 0x3ff;
+		v = (v | (v << 16)) & 0x030000ff;
+		v = (v | (v << 8)) & 0x0300f00f;
+		v = (v | (v << 4)) & 0x030c30c3;
+		v = (v | (v << 2)) & 0x09249249;
+		return v;
+	}
+	// 30 bit Morton code of a point in [0, 1]^3
+	unsigned MortonCode(const glm::vec3& unit)
+	{
+		glm::vec3 cell = glm::clamp(unit * 1023.f, glm::vec3(0.f), glm::vec3(1023.f));
+		return (SpreadBits(static_cast<unsigned>(cell.x)) << 2) | (SpreadBits(static_cast<unsigned>(cell.y)) << 1)
+			| SpreadBits(static_cast<unsigned>(cell.z));
+	}
+}
 
 void SoftBodyPhysics::Init()
 {
 	m_gravity = GRAVITY;
-	m_scaled_ver = obj_vertices;
+	std::vector<glm::vec3> scaled_ver = obj_vertices;
 
-	m_scaled_ver.push_back(position);
+	scaled_ver.push_back(position);
 
-	unsigned ver = static_cast<unsigned>(m_scaled_ver.size());
+	unsigned ver = static_cast<unsigned>(scaled_ver.size());
 	for (unsigned i = 0; i < ver-1; ++i)
-		m_scaled_ver[i] = position + m_scaled_ver[i]*scale;
+		scaled_ver[i] = position + scaled_ver[i]*scale;
+	m_scaled_ver.assign(scaled_ver);
 	m_old_ver = m_scaled_ver;
+	// the broadphase reads the bounds of bodies that never ran Update on the CPU
+	ComputeBounds(m_scaled_ver, m_scaled_ver.size() - 1, m_min, m_max);
 	stiffness = 0.3f;
 	damping = 0.5f;
 
 	isCollided = false;
+	tree_min_triangles = SOFT_TREE_MIN_TRIANGLES;
+	m_tree_dirty = true;
+	m_contact_moved = false;
+	m_gpu = nullptr;
 
 	if(m_shape == ObjShape::O_PLANE)
 	{ 
 		m_mass = 0.3f;
-		m_acceleration = std::vector<glm::vec3>(ver, glm::vec3(0, m_gravity * m_mass, 0));
-		m_velocity = std::vector<glm::vec3>(ver, glm::vec3(0));
+		m_acceleration.assign(ver, glm::vec3(0, m_gravity * m_mass, 0));
+		m_velocity.assign(ver, glm::vec3(0));
 
 		for(int i = 0; i <= dimension; ++i)
-			m_edge.push_back(std::make_pair(i, m_scaled_ver[i]));
+			m_edge.push_back(std::make_pair(i, scaled_ver[i]));
 
 		//set constraints
 		//horizontal
@@ -73,8 +144,8 @@ void SoftBodyPhysics::Init()
 	else if (m_shape == ObjShape::O_SPHERE)
 	{
 		m_mass = 0.4f;
-		m_acceleration = std::vector<glm::vec3>(ver, glm::vec3(0, m_gravity * m_mass, 0));
-		m_velocity = std::vector<glm::vec3>(ver, glm::vec3(0));
+		m_acceleration.assign(ver, glm::vec3(0, m_gravity * m_mass, 0));
+		m_velocity.assign(ver, glm::vec3(0));
 
 		//up & down side
 		for (int i = 1; i <= dimension; ++i)
@@ -99,7 +170,7 @@ void SoftBodyPhysics::Init()
 			constraints cons;
 			cons.p1 = obj_indices[curr];
 			cons.p2 = obj_indices[i];
-			cons.restlen = glm::distance(m_scaled_ver[cons.p1], m_scaled_ver[cons.p2]);
+			cons.restlen = glm::distance(scaled_ver[cons.p1], scaled_ver[cons.p2]);
 			m_const.insert(cons);
 
 			curr = i;
@@ -122,13 +193,79 @@ void SoftBodyPhysics::Init()
 				vol_cons2.p2 = (dimension + 1) * (unit + i) + j;
 				vol_cons1.p2 = vol_cons2.p2 + unit;
 
-				vol_cons1.restlen = glm::distance(m_scaled_ver[vol_cons1.p1], m_scaled_ver[vol_cons1.p2]);
-				vol_cons2.restlen = glm::distance(m_scaled_ver[vol_cons2.p1], m_scaled_ver[vol_cons2.p2]);
+				vol_cons1.restlen = glm::distance(scaled_ver[vol_cons1.p1], scaled_ver[vol_cons1.p2]);
+				vol_cons2.restlen = glm::distance(scaled_ver[vol_cons2.p1], scaled_ver[vol_cons2.p2]);
 
 				m_volume_cons.insert(std::make_pair(vol_cons1, vol_cons2));
 			}
 		}
 	}
+
+	CompileConstraints();
+	BuildNormalAdjacency();
+	ComputeNormals();
+	m_normals_dirty = false;
+	// the particles are redrawn every frame
+	MakeDynamic();
+}
+
+SoftBodyPhysics::~SoftBodyPhysics()
+{
+	delete m_gpu;
+}
+
+bool SoftBodyPhysics::UseGpu(bool enable)
+{
+	if (!enable)
+	{
+		if (m_gpu)
+		{
+			m_gpu->ReadBack(m_scaled_ver, m_old_ver);
+			delete m_gpu;
+			m_gpu = nullptr;
+			m_tree_dirty = true;
+			m_normals_dirty = true;
+		}
+		return true;
+	}
+	if (m_gpu)
+		return true;
+	if (!VertexBuffer() || !GpuSoftBody::Supported())
+		return false;
+
+	GpuSoftBodyData data;
+	data.pos = &m_scaled_ver;
+	data.old = &m_old_ver;
+	data.distance = &m_const_flat;
+	data.distance_batches = &m_const_batches;
+	data.volume = &m_volume_flat;
+	data.volume_batches = &m_volume_batches;
+	for (auto& edge : m_edge)
+	{
+		GpuPin pin = { edge.second, static_cast<int>(edge.first) };
+		data.pins.push_back(pin);
+	}
+	data.faces = &m_faces;
+	data.face_start = &m_vertex_face_start;
+	data.vertex_faces = &m_vertex_faces;
+	data.weld = &m_normal_weld;
+	unsigned anchors[6] = { right, left, front, back, up, bottom };
+	for (unsigned i = 0; i < 6; ++i)
+		data.anchors[i] = anchors[i];
+	// attributes back on the plain buffers, Stream points them at its ring
+	Describe();
+	data.vbo = VertexBuffer();
+	data.normal_buffer = NormalBuffer();
+	data.vertex_count = static_cast<unsigned>(obj_vertices.size());
+
+	m_gpu = new GpuSoftBody;
+	m_gpu->Upload(data);
+	return true;
+}
+
+void SoftBodyPhysics::UpdateGpu(float dt, const std::vector<GpuCollider>& colliders)
+{
+	m_gpu->Step(dt, glm::vec3(0, m_gravity * m_mass, 0), stiffness * dt * KEEP_CONS_SPEED, KEEP_CONS_ITERATIONS, colliders);
 }
 
 void SoftBodyPhysics::Update(float dt)
@@ -139,129 +276,227 @@ void SoftBodyPhysics::Update(float dt)
 
 	KeepConstraint(dt);
 
-	position = m_scaled_ver[m_scaled_ver.size() - 1];
+	position = m_scaled_ver.get(m_scaled_ver.size() - 1);
 	glm::vec3 center = glm::vec3(0);
-	m_min = m_scaled_ver[0];
-	m_max = m_scaled_ver[0];
-	
-	center += m_scaled_ver[right];
-	center += m_scaled_ver[left];
-	center += m_scaled_ver[front];
-	center += m_scaled_ver[back];
-	center += m_scaled_ver[up];
-	center += m_scaled_ver[bottom];
+
+	center += m_scaled_ver.get(right);
+	center += m_scaled_ver.get(left);
+	center += m_scaled_ver.get(front);
+	center += m_scaled_ver.get(back);
+	center += m_scaled_ver.get(up);
+	center += m_scaled_ver.get(bottom);
 
 	position = center;
 	position.x /= 6;
 	position.y /= 6;
 	position.z /= 6;
 
-	for (unsigned i = 0; i < m_scaled_ver.size() - 1; ++i)
+	// bounds of every particle but the trailing center point
+	unsigned count = m_scaled_ver.size() - 1;
+	ComputeBounds(m_scaled_ver, count, m_min, m_max);
+	m_tree_dirty = true;
+}
+
+void SoftBodyPhysics::Interpolate(float alpha)
+{
+	if (m_gpu)
 	{
-		if (m_min.x > m_scaled_ver[i].x)
-			m_min.x = m_scaled_ver[i].x;
-		if (m_max.x < m_scaled_ver[i].x)
-			m_max.x = m_scaled_ver[i].x;
-		if (m_min.y > m_scaled_ver[i].y)
-			m_min.y = m_scaled_ver[i].y;
-		if (m_max.y < m_scaled_ver[i].y)
-			m_max.y = m_scaled_ver[i].y;
-		if (m_min.z > m_scaled_ver[i].z)
-			m_min.z = m_scaled_ver[i].z;
-		if (m_max.z < m_scaled_ver[i].z)
-			m_max.z = m_scaled_ver[i].z;
-
-		obj_vertices[i] = (m_scaled_ver[i] - position) / scale;
+		// position only has to match between the output and the draw, an older one is fine
+		glm::vec3 center;
+		if (m_gpu->ReadAnchors(center))
+			position = center;
+		m_gpu->Output(alpha, position, scale);
+		return;
 	}
+	// m_old_ver still holds where the particles ended the previous step, verlet keeps it that way
+	const float* x0 = m_old_ver.x.data();
+	const float* y0 = m_old_ver.y.data();
+	const float* z0 = m_old_ver.z.data();
+	const float* x1 = m_scaled_ver.x.data();
+	const float* y1 = m_scaled_ver.y.data();
+	const float* z1 = m_scaled_ver.z.data();
+	float beta = 1.f - alpha;
+	unsigned count = m_scaled_ver.size() - 1;
+	for (unsigned i = 0; i < count; ++i)
+	{
+		glm::vec3 point(beta * x0[i] + alpha * x1[i], beta * y0[i] + alpha * y1[i], beta * z0[i] + alpha * z1[i]);
+		glm::vec3 vertex = (point - position) / scale;
+		if (vertex != obj_vertices[i])
+		{
+			obj_vertices[i] = vertex;
+			m_normals_dirty = true;
+		}
+	}
+}
+
+void SoftBodyPhysics::UpdateNormals()
+{
+	if (!m_normals_dirty)
+		return;
+	ComputeNormals();
+	m_normals_dirty = false;
 }
 
 void SoftBodyPhysics::Verlet(float dt)
 {
 	float f = 0.99f;
-	for (unsigned i = 0; i < m_scaled_ver.size(); ++i)
-	{
-		glm::vec3* _new = &m_scaled_ver[i];
-		glm::vec3 temp = *_new;
-		glm::vec3* old = &m_old_ver[i];
-		
-
-		(*_new) +=  f * temp - f * (*old) + m_acceleration[i] * dt * dt;
-		(*old) = temp;
-	}
+	// padding lanes hold zero position and acceleration, so the whole padded range is integrated
+	IntegrateVerlet(m_scaled_ver, m_old_ver, m_acceleration, f, dt);
 }
 
 void SoftBodyPhysics::Move(float dt)
 {
 	for (unsigned i = 0; i < m_scaled_ver.size(); ++i)
 	{
-		m_old_ver[i] = m_scaled_ver[i];
-		m_velocity[i] += m_acceleration[i] * dt;
-		m_scaled_ver[i] += m_velocity[i] * dt;
+		m_old_ver.set(i, m_scaled_ver.get(i));
+		m_velocity.add(i, m_acceleration.get(i) * dt);
+		m_scaled_ver.add(i, m_velocity.get(i) * dt);
 	}
 }
 
 void SoftBodyPhysics::KeepConstraint(float dt)
 {
-	for (int i = 0; i < 7; ++i)
+	ThreadPool& pool = ThreadPool::Instance();
+	for (int i = 0; i < KEEP_CONS_ITERATIONS; ++i)
 	{
 		//staying edge
 		for (unsigned j = 0; j < m_edge.size(); ++j)
-			m_scaled_ver[m_edge[j].first] = m_edge[j].second;
+			m_scaled_ver.set(m_edge[j].first, m_edge[j].second);
 
-		for (auto& j : m_const)
+		// constraints of one color share no particle, so a batch can be split across threads
+		// and still give the same result as solving it in order
+		for (unsigned c = 0; c + 1 < m_const_batches.size(); ++c)
 		{
-			glm::vec3& point1 = m_scaled_ver[j.p1];
-			glm::vec3& point2 = m_scaled_ver[j.p2];
-			glm::vec3& old_1 = m_old_ver[j.p1];
-			glm::vec3& old_2 = m_old_ver[j.p2];
+			unsigned first = m_const_batches[c];
+			pool.ParallelFor(m_const_batches[c + 1] - first, PARALLEL_MIN_BATCH,
+				[this, first, dt](unsigned begin, unsigned end) {
+				const constraints* batch = m_const_flat.data() + first;
+				for (unsigned j = begin; j < end; ++j)
+					SolveDistanceConstraint(batch[j], dt);
+			});
+		}
 
-			glm::vec3 delta = point2 - point1;
-			if (delta == glm::vec3(0, 0, 0))
-				continue;
+		for (unsigned c = 0; c + 1 < m_volume_batches.size(); ++c)
+		{
+			unsigned first = m_volume_batches[c];
+			pool.ParallelFor(m_volume_batches[c + 1] - first, PARALLEL_MIN_BATCH,
+				[this, first, dt](unsigned begin, unsigned end) {
+				const volume_constraints* batch = m_volume_flat.data() + first;
+				for (unsigned j = begin; j < end; ++j)
+					SolveVolumeConstraint(batch[j], dt);
+			});
+		}
+	}
+}
 
-			float len = glm::sqrt(delta.x * delta.x + delta.y * delta.y + delta.z * delta.z);
-			float diff = (len - j.restlen) / len;
+void SoftBodyPhysics::SolveDistanceConstraint(const constraints& j, float dt)
+{
+	glm::vec3 point1 = m_scaled_ver.get(j.p1);
+	glm::vec3 point2 = m_scaled_ver.get(j.p2);
 
-			glm::vec3 force = stiffness * delta * diff * dt * KEEP_CONS_SPEED;
-	
-			point1 += force;
-			point2 -= force;
-		}
+	glm::vec3 delta = point2 - point1;
+	if (delta == glm::vec3(0, 0, 0))
+		return;
 
-		for (auto& j : m_volume_cons)
-		{
-			glm::vec3& point1 = m_scaled_ver[j.first.p1];
-			glm::vec3& point2 = m_scaled_ver[j.first.p2];
-			glm::vec3& old_1 = m_old_ver[j.first.p1];
-			glm::vec3& old_2 = m_old_ver[j.first.p2];
+	float len = glm::sqrt(delta.x * delta.x + delta.y * delta.y + delta.z * delta.z);
+	float diff = (len - j.restlen) / len;
 
-			glm::vec3& point3 = m_scaled_ver[j.second.p1];
-			glm::vec3& point4 = m_scaled_ver[j.second.p2];
-			glm::vec3& old_3 = m_old_ver[j.second.p1];
-			glm::vec3& old_4 = m_old_ver[j.second.p2];
+	glm::vec3 force = stiffness * delta * diff * dt * KEEP_CONS_SPEED;
 
-			glm::vec3 delta1 = point2 - point1;
-			glm::vec3 delta2 = point4 - point3;
+	m_scaled_ver.add(j.p1, force);
+	m_scaled_ver.add(j.p2, -force);
+}
 
-			float len = glm::distance(point2, point1) + glm::distance(point4, point3);
-			float diff = (len - j.first.restlen - j.second.restlen) / len;
+void SoftBodyPhysics::SolveVolumeConstraint(const volume_constraints& j, float dt)
+{
+	glm::vec3 point1 = m_scaled_ver.get(j.p1);
+	glm::vec3 point2 = m_scaled_ver.get(j.p2);
 
-			glm::vec3 force1 = stiffness * delta1 * diff * 0.5f * dt * KEEP_CONS_SPEED;
-			point1 += force1;
-			point2 -= force1;
+	glm::vec3 point3 = m_scaled_ver.get(j.p3);
+	glm::vec3 point4 = m_scaled_ver.get(j.p4);
 
-			glm::vec3 force2 = stiffness * delta2 * diff * 0.5f * dt * KEEP_CONS_SPEED;
-			point3 += force2;
-			point4 -= force2;
+	glm::vec3 delta1 = point2 - point1;
+	glm::vec3 delta2 = point4 - point3;
 
-		}
+	float len = glm::distance(point2, point1) + glm::distance(point4, point3);
+	float diff = (len - j.restlen1 - j.restlen2) / len;
+
+	glm::vec3 force1 = stiffness * delta1 * diff * 0.5f * dt * KEEP_CONS_SPEED;
+	m_scaled_ver.add(j.p1, force1);
+	m_scaled_ver.add(j.p2, -force1);
+
+	glm::vec3 force2 = stiffness * delta2 * diff * 0.5f * dt * KEEP_CONS_SPEED;
+	m_scaled_ver.add(j.p3, force2);
+	m_scaled_ver.add(j.p4, -force2);
+}
+
+void SoftBodyPhysics::CompileConstraints()
+{
+	unsigned ver = m_scaled_ver.size();
+
+	// Morton code of every particle's rest position inside the body's bounds
+	glm::vec3 min = m_scaled_ver.get(0), max = m_scaled_ver.get(0);
+	for (unsigned i = 0; i < ver; ++i)
+	{
+		min = glm::min(min, m_scaled_ver.get(i));
+		max = glm::max(max, m_scaled_ver.get(i));
+	}
+	glm::vec3 extent = glm::max(max - min, glm::vec3(1e-6f));
+	std::vector<unsigned> morton(ver);
+	for (unsigned i = 0; i < ver; ++i)
+	{
+		glm::vec3 unit = (m_scaled_ver.get(i) - min) / extent;
+		morton[i] = MortonCode(unit);
 	}
+
+	std::vector<constraints> distance(m_const.begin(), m_const.end());
+	std::stable_sort(distance.begin(), distance.end(), [&morton](const constraints& a, const constraints& b) {
+		return morton[a.p1] < morton[b.p1];
+	});
+
+	std::vector<volume_constraints> volume;
+	for (auto& j : m_volume_cons)
+	{
+		volume_constraints v;
+		v.p1 = j.first.p1;
+		v.p2 = j.first.p2;
+		v.p3 = j.second.p1;
+		v.p4 = j.second.p2;
+		v.restlen1 = j.first.restlen;
+		v.restlen2 = j.second.restlen;
+		volume.push_back(v);
+	}
+	std::stable_sort(volume.begin(), volume.end(), [&morton](const volume_constraints& a, const volume_constraints& b) {
+		return morton[a.p1] < morton[b.p1];
+	});
+
+	// used[c][p] is set when particle p already appears in color c
+	std::vector<std::vector<char>> used;
+	std::vector<unsigned> color(distance.size());
+	for (unsigned j = 0; j < distance.size(); ++j)
+	{
+		int particles[2] = { distance[j].p1, distance[j].p2 };
+		color[j] = FirstFreeColor(used, particles, 2, ver);
+	}
+	GroupByColor(distance, color, static_cast<unsigned>(used.size()), m_const_flat, m_const_batches);
+
+	used.clear();
+	color.resize(volume.size());
+	for (unsigned j = 0; j < volume.size(); ++j)
+	{
+		int particles[4] = { volume[j].p1, volume[j].p2, volume[j].p3, volume[j].p4 };
+		color[j] = FirstFreeColor(used, particles, 4, ver);
+	}
+	GroupByColor(volume, color, static_cast<unsigned>(used.size()), m_volume_flat, m_volume_batches);
+
+	m_const.clear();
+	m_volume_cons.clear();
 }
 
 void SoftBodyPhysics::Acceleration()
 {
 	for(unsigned i = 0; i < m_acceleration.size(); ++i)
-		m_acceleration[i] = glm::vec3(0, m_gravity* m_mass, 0);
+		m_acceleration.set(i, glm::vec3(0, m_gravity* m_mass, 0));
 }
 
 void SoftBodyPhysics::CollisionResponseRigid(Object* _rhs)
@@ -271,15 +506,16 @@ void SoftBodyPhysics::CollisionResponseRigid(Object* _rhs)
 		glm::vec3 center = _rhs->position;
 		float radius = _rhs->scale.x + 0.01f;
 		float radius_sqr = radius * radius;
-		for (unsigned i = 0; i < m_scaled_ver.size(); ++i)
+		for (unsigned i = 0; i < m_contact_ver.size(); ++i)
 		{
-			glm::vec3& point = m_scaled_ver[i];
+			glm::vec3 point = m_contact_ver.get(i);
 			if (IsCollided(point, center, radius_sqr))
 			{
 				glm::vec3 normal = point - center;
 				normal = glm::normalize(normal);
 
-				m_scaled_ver[i] = center + normal * radius;
+				m_contact_ver.set(i, center + normal * radius);
+				m_contact_moved = true;
 			}
 		}
 	}
@@ -295,26 +531,27 @@ void SoftBodyPhysics::CollisionResponseRigid(Object* _rhs)
 		glm::vec3 v = point1 - point0;
 		glm::vec3 w = point2 - point0;
 
-		//check distance
-		_rhs->normalVec = glm::cross(v, w);
-		_rhs->normalVec = glm::normalize(_rhs->normalVec);
+		//check distance, kept local since several bodies test the same plane at once
+		glm::vec3 normalVec = glm::cross(v, w);
+		normalVec = glm::normalize(normalVec);
 
-		_rhs->d = -glm::dot(_rhs->normalVec, point0);
+		float d = -glm::dot(normalVec, point0);
 			
 		float radius = 0.f;
 		bool collision = false;
-		for (unsigned i = 0; i < m_scaled_ver.size(); ++i)
+		for (unsigned i = 0; i < m_contact_ver.size(); ++i)
 		{
-			glm::vec3& point = m_scaled_ver[i];
+			glm::vec3 point = m_contact_ver.get(i);
 			float distance = 0;
-			glm::vec3 moved = m_scaled_ver[i];
+			glm::vec3 moved = point;
 
-			glm::vec3 l_norm = _rhs->normalVec;
+			glm::vec3 l_norm = normalVec;
 
-			collision = IsCollidedPlane(point, point0, point1, radius, distance, l_norm, _rhs->d, moved);
+			collision = IsCollidedPlane(point, point0, point1, radius, distance, l_norm, d, moved);
 			if (collision)
 			{
-				m_scaled_ver[i] = moved;
+				m_contact_ver.set(i, moved);
+				m_contact_moved = true;
 				isCollided = true;
 			}
 		}
@@ -332,11 +569,17 @@ void SoftBodyPhysics::CollisionResponseSoft(SoftBodyPhysics* _rhs)
 		return;
 
 	glm::vec3 direction = _rhs->position - position;
+	if (_rhs->TriangleCount() >= _rhs->tree_min_triangles && !_rhs->m_tree.empty())
+	{
+		CollisionResponseTree(_rhs, direction);
+		return;
+	}
+
 	for (unsigned j = 0; j < _rhs->obj_indices.size() - 3; j += 3)
 	{
-		glm::vec3 point0 = _rhs->m_scaled_ver[_rhs->obj_indices[j]];
-		glm::vec3 point1 = _rhs->m_scaled_ver[_rhs->obj_indices[j+2]];
-		glm::vec3 point2 = _rhs->m_scaled_ver[_rhs->obj_indices[j+1]];
+		glm::vec3 point0 = _rhs->m_scaled_ver.get(_rhs->obj_indices[j]);
+		glm::vec3 point1 = _rhs->m_scaled_ver.get(_rhs->obj_indices[j+2]);
+		glm::vec3 point2 = _rhs->m_scaled_ver.get(_rhs->obj_indices[j+1]);
 		
 		if (glm::dot(-direction, point0 - _rhs->position) < 0)
 			continue;
@@ -350,28 +593,116 @@ void SoftBodyPhysics::CollisionResponseSoft(SoftBodyPhysics* _rhs)
 
 		float d = -glm::dot(normalvec, point0);
 		
-		for (unsigned i = 0; i < m_scaled_ver.size(); ++i)
+		for (unsigned i = 0; i < m_contact_ver.size(); ++i)
 		{
-			glm::vec3& point = m_scaled_ver[i];
+			glm::vec3 point = m_contact_ver.get(i);
 			
 			if (glm::dot(direction, point - position) < 0)
 				continue;
 
 			float distance = 0;
-			glm::vec3 moved = m_scaled_ver[i];
+			glm::vec3 moved = point;
 
 			glm::vec3 l_norm = normalvec;
 
-			collision = IsCollidedPlane(point, point0, point1, radius, distance, l_norm, d, moved);
-			if (collision)
+			if (IsCollidedPlane(point, point0, point1, radius, distance, l_norm, d, moved))
 			{
-				m_scaled_ver[i] = moved;
-				isCollided = true;
+				m_contact_ver.set(i, moved);
+				m_contact_moved = true;
+				collision = true;
 			}
 		}
 	}
-	if (!collision)
-		isCollided = false;
+	// any triangle pushing any vertex, like CollisionResponseTree
+	isCollided = collision;
+}
+
+void SoftBodyPhysics::BeginContacts()
+{
+	if (TriangleCount() >= tree_min_triangles)
+		UpdateTree();
+	m_contact_ver = m_scaled_ver;
+	m_contact_moved = false;
+}
+
+void SoftBodyPhysics::EndContacts()
+{
+	if (!m_contact_moved)
+		return;
+	m_scaled_ver.swap(m_contact_ver);
+	m_tree_dirty = true;
+}
+
+unsigned SoftBodyPhysics::TriangleCount() const
+{
+	// CollisionResponseSoft never looked at the last triangle, the tree keeps that
+	unsigned indices = static_cast<unsigned>(obj_indices.size());
+	return indices > 3 ? (indices - 1) / 3 : 0;
+}
+
+void SoftBodyPhysics::UpdateTree()
+{
+	if (m_tree.empty())
+	{
+		// a vertex can sit CONTACT_DEPTH outside the box of point0 / point1 and still be pushed into it
+		m_tree.Build(m_scaled_ver, obj_indices, TriangleCount(), CONTACT_DEPTH + 1e-3f);
+		m_tree_dirty = false;
+	}
+	else if (m_tree_dirty)
+	{
+		m_tree.Refit(m_scaled_ver);
+		m_tree_dirty = false;
+	}
+}
+
+void SoftBodyPhysics::CollisionResponseTree(SoftBodyPhysics* _rhs, const glm::vec3& direction)
+{
+	const TriangleTree& tree = _rhs->m_tree;
+
+	float radius = 0.0f;
+	bool collision = false;
+	for (unsigned i = 0; i < m_contact_ver.size(); ++i)
+	{
+		glm::vec3 point = m_contact_ver.get(i);
+		if (glm::dot(direction, point - position) < 0)
+			continue;
+
+		// same triangles in the same order as the full loop, just without the ones that can't touch the vertex.
+		// The query box has some slack so a pushed vertex rarely needs a new query.
+		glm::vec3 anchor = point;
+		tree.Query(anchor - glm::vec3(TREE_QUERY_SLACK), anchor + glm::vec3(TREE_QUERY_SLACK), m_tree_hits);
+		for (unsigned k = 0; k < m_tree_hits.size();)
+		{
+			unsigned t = m_tree_hits[k++];
+			glm::vec3 point0 = _rhs->m_scaled_ver.get(tree.corner0(t));
+			if (glm::dot(-direction, point0 - _rhs->position) < 0)
+				continue;
+			glm::vec3 point1 = _rhs->m_scaled_ver.get(tree.corner1(t));
+
+			float distance = 0;
+			glm::vec3 moved = point;
+			glm::vec3 l_norm = tree.normal(t);
+			if (!IsCollidedPlane(point, point0, point1, radius, distance, l_norm, tree.d(t), moved))
+				continue;
+
+			point = moved;
+			m_contact_ver.set(i, moved);
+			m_contact_moved = true;
+			collision = true;
+
+			// the full loop skips a vertex pushed to the far side for the remaining triangles
+			if (glm::dot(direction, point - position) < 0)
+				break;
+			glm::vec3 offset = glm::abs(point - anchor);
+			if (offset.x <= TREE_QUERY_SLACK && offset.y <= TREE_QUERY_SLACK && offset.z <= TREE_QUERY_SLACK)
+				continue;
+			// pushed out of the queried box, carry on after t with a new query
+			anchor = point;
+			tree.Query(anchor - glm::vec3(TREE_QUERY_SLACK), anchor + glm::vec3(TREE_QUERY_SLACK), m_tree_hits);
+			k = static_cast<unsigned>(std::upper_bound(m_tree_hits.begin(), m_tree_hits.end(), t) - m_tree_hits.begin());
+		}
+	}
+	isCollided = collision;
 }
 
 bool SoftBodyPhysics::IsCollided(glm::vec3& point, glm::vec3& center, float& radius)
@@ -392,7 +723,7 @@ bool SoftBodyPhysics::IsCollidedPlane(glm::vec3& point, glm::vec3& p_point0, glm
 {
 	distance = glm::dot(point, norm) + d;
 
-	if (std::abs(distance) < 0.2f && distance < 0.f)
+	if (std::abs(distance) < CONTACT_DEPTH && distance < 0.f)
 	{
 		movedpoint = point - (distance * norm);
 
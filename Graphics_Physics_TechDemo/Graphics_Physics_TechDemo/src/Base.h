@@ -16,10 +16,27 @@ End Header --------------------------------------------------------*/
 #define BASE_H
 
 #include "Object.h"
+#include "Particle.h"
+#include "TriangleTree.h"
 #include <set>
 
-#define GRAVITY -9.8f
+class GpuSoftBody;
+struct GpuCollider;
 
+#define GRAVITY -9.8f
+// relaxation passes over every constraint in KeepConstraint
+#define KEEP_CONS_ITERATIONS 7
+// softbodies with at least this many triangles are collided against through their triangle tree
+#define SOFT_TREE_MIN_TRIANGLES 64
+// depth below a triangle plane that still counts as contact in IsCollidedPlane
+#define CONTACT_DEPTH 0.2f
+
+
+struct volume_constraints {
+	int p1, p2, p3, p4; // p1-p2 and p3-p4 keep their summed length
+	float restlen1;
+	float restlen2;
+};
 
 struct constraints {
 	constraints() { p1 = 0; p2 = 0; restlen = 0; }
@@ -40,44 +57,96 @@ public:
 	SoftBodyPhysics(ObjectShape shape, glm::vec3 pos, glm::vec3 scale_, int dim):Object(shape, pos, scale_, dim) {
 		Init();
 	}
+	~SoftBodyPhysics();
 	void Init();
 	void Update(float dt);
+	// obj_vertices at alpha between the previous and the current step, drawn around position
+	void Interpolate(float alpha);
+	// recompute vertexNormals if Interpolate moved any vertex since the last call
+	void UpdateNormals();
+	void Verlet(float dt);
 	void KeepConstraint(float dt);
+	unsigned ConstraintCount() const { return static_cast<unsigned>(m_const_flat.size() + m_volume_flat.size()); }
+	// solver arrays, batch c is [batches[c], batches[c + 1])
+	const std::vector<constraints>& DistanceConstraints() const { return m_const_flat; }
+	const std::vector<unsigned>& DistanceBatches() const { return m_const_batches; }
+	const std::vector<volume_constraints>& VolumeConstraints() const { return m_volume_flat; }
+	const std::vector<unsigned>& VolumeBatches() const { return m_volume_batches; }
+
+	// collisions push a copy of the particles and only read the other bodies' m_scaled_ver,
+	// so every body can resolve its contacts at the same time. EndContacts applies the copy.
+	void BeginContacts();
 	void CollisionResponseRigid(Object* _rhs);
 	void CollisionResponseSoft(SoftBodyPhysics* _rhs);
+	void EndContacts();
+
+	// move the body to the compute shader backend or back, false when the context can't run it.
+	// A GPU body only collides with rigid bodies, Physics::UseGpu keeps it to a lone softbody.
+	// It is stepped with UpdateGpu instead of Update
+	bool UseGpu(bool enable);
+	bool on_gpu() const { return m_gpu != nullptr; }
+	void UpdateGpu(float dt, const std::vector<GpuCollider>& colliders);
 
 	void SetInitConstraints() { m_cons = m_init_cons; }
 	bool colliding() { return isCollided; }
 
-	std::vector<glm::vec3> m_scaled_ver;
+	ParticleArray m_scaled_ver;
 	glm::vec3 m_min;
 	glm::vec3 m_max;
 
 	float m_mass;
 	float stiffness;
 	float damping;
+	// triangle count from which other bodies query the tree instead of testing every triangle
+	unsigned tree_min_triangles;
 private:
-	void Verlet(float dt);
 	void Move(float dt);
 	
 	void Acceleration();
 
+	// flatten m_const / m_volume_cons into color batches whose constraints share no particle
+	void CompileConstraints();
+	void SolveDistanceConstraint(const constraints& j, float dt);
+	void SolveVolumeConstraint(const volume_constraints& j, float dt);
+
+	unsigned TriangleCount() const;
+	// refit m_tree if any particle moved since the last refit
+	void UpdateTree();
+	void CollisionResponseTree(SoftBodyPhysics* _rhs, const glm::vec3& direction);
+
 	bool IsCollided(glm::vec3& point, glm::vec3& center, float& radius);
 	bool IsCollidedPlane(glm::vec3& point, glm::vec3& p_point0, glm::vec3& p_point1, float& radius, float& distance, glm::vec3& norm, float d
 	, glm::vec3& movedpoint);
 
-	std::vector<glm::vec3> m_old_ver;
+	ParticleArray m_old_ver;
 	std::vector<constraints> m_init_cons;
 	std::vector<constraints> m_cons;
 	std::vector<constraints> m_in_cons;
+	// only used while building in Init to drop duplicates, emptied by CompileConstraints
 	std::set<constraints> m_const;
 	std::set<std::pair<constraints, constraints>> m_volume_cons;
 
+	// solver arrays: batch c is [m_*_batches[c], m_*_batches[c + 1]), Morton ordered inside a batch
+	std::vector<constraints> m_const_flat;
+	std::vector<unsigned> m_const_batches;
+	std::vector<volume_constraints> m_volume_flat;
+	std::vector<unsigned> m_volume_batches;
+
 	float m_gravity;
-	std::vector<glm::vec3> m_acceleration;
-	std::vector<glm::vec3> m_velocity;
+	ParticleArray m_acceleration;
+	ParticleArray m_velocity;
 	bool isCollided;
 
+	TriangleTree m_tree;
+	bool m_tree_dirty;
+	std::vector<unsigned> m_tree_hits;
+
+	ParticleArray m_contact_ver;
+	bool m_contact_moved;
+
+	bool m_normals_dirty;
+	GpuSoftBody* m_gpu;
+
 	std::vector <std::pair<unsigned, glm::vec3>> m_edge;
 };
 
@@ -0,0 +1,127 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: Broadphase.cpp
+Purpose: Uniform grid spatial hash over softbody bounds, overlapping pair search
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#include "Broadphase.h"
+#include "Base.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	bool Overlap(const glm::vec3& min1, const glm::vec3& max1, const glm::vec3& min2, const glm::vec3& max2)
+	{
+		return min1.x <= max2.x && max1.x >= min2.x
+			&& min1.y <= max2.y && max1.y >= min2.y
+			&& min1.z <= max2.z && max1.z >= min2.z;
+	}
+}
+
+long long Broadphase::CellKey(int x, int y, int z) const
+{
+	// 21 bits per axis, wraps around far from the origin which only costs extra narrow tests
+	return (static_cast<long long>(x & 0x1FFFFF) << 42)
+		| (static_cast<long long>(y & 0x1FFFFF) << 21)
+		| static_cast<long long>(z & 0x1FFFFF);
+}
+
+void Broadphase::FindPairs(const std::vector<SoftBodyPhysics*>& bodies, std::vector<std::pair<unsigned, unsigned>>& pairs)
+{
+	pairs.clear();
+	unsigned count = static_cast<unsigned>(bodies.size());
+	if (count < 2)
+		return;
+
+	m_min.resize(count);
+	m_max.resize(count);
+	for (unsigned i = 0; i < count; ++i)
+	{
+		m_min[i] = bodies[i]->m_min - glm::vec3(BROADPHASE_MARGIN);
+		m_max[i] = bodies[i]->m_max + glm::vec3(BROADPHASE_MARGIN);
+	}
+	FindBoxPairs(pairs);
+}
+
+void Broadphase::FindPairs(const std::vector<glm::vec3>& min, const std::vector<glm::vec3>& max, std::vector<std::pair<unsigned, unsigned>>& pairs)
+{
+	pairs.clear();
+	if (min.size() < 2)
+		return;
+	m_min = min;
+	m_max = max;
+	FindBoxPairs(pairs);
+}
+
+void Broadphase::FindBoxPairs(std::vector<std::pair<unsigned, unsigned>>& pairs)
+{
+	unsigned count = static_cast<unsigned>(m_min.size());
+
+	// cell size follows the average body, so a typical body lands in one to eight cells
+	float cell_size = 0.f;
+	for (unsigned i = 0; i < count; ++i)
+	{
+		glm::vec3 extent = m_max[i] - m_min[i];
+		cell_size += std::max(extent.x, std::max(extent.y, extent.z));
+	}
+	cell_size /= count;
+	if (!(cell_size > 0.f))
+		cell_size = 1.f;
+	float inv_cell = 1.f / cell_size;
+
+	// cells are kept between steps to reuse their storage, drop them once moving bodies left too many behind
+	if (m_cells.size() > BROADPHASE_MAX_CELLS * count)
+		m_cells.clear();
+	for (auto& cell : m_cells)
+		cell.second.clear();
+	m_oversized.clear();
+
+	for (unsigned i = 0; i < count; ++i)
+	{
+		int x0 = static_cast<int>(std::floor(m_min[i].x * inv_cell));
+		int y0 = static_cast<int>(std::floor(m_min[i].y * inv_cell));
+		int z0 = static_cast<int>(std::floor(m_min[i].z * inv_cell));
+		int x1 = static_cast<int>(std::floor(m_max[i].x * inv_cell));
+		int y1 = static_cast<int>(std::floor(m_max[i].y * inv_cell));
+		int z1 = static_cast<int>(std::floor(m_max[i].z * inv_cell));
+
+		long long cells = static_cast<long long>(x1 - x0 + 1) * (y1 - y0 + 1) * (z1 - z0 + 1);
+		if (cells > BROADPHASE_MAX_CELLS)
+		{
+			m_oversized.push_back(i);
+			continue;
+		}
+		for (int x = x0; x <= x1; ++x)
+			for (int y = y0; y <= y1; ++y)
+				for (int z = z0; z <= z1; ++z)
+					m_cells[CellKey(x, y, z)].push_back(i);
+	}
+
+	for (auto& cell : m_cells)
+	{
+		const std::vector<unsigned>& ids = cell.second;
+		for (unsigned a = 0; a < ids.size(); ++a)
+			for (unsigned b = a + 1; b < ids.size(); ++b)
+				if (Overlap(m_min[ids[a]], m_max[ids[a]], m_min[ids[b]], m_max[ids[b]]))
+					pairs.push_back(std::make_pair(ids[a], ids[b]));
+	}
+	for (unsigned big : m_oversized)
+		for (unsigned i = 0; i < count; ++i)
+		{
+			if (i == big)
+				continue;
+			if (Overlap(m_min[big], m_max[big], m_min[i], m_max[i]))
+				pairs.push_back(std::make_pair(std::min(big, i), std::max(big, i)));
+		}
+
+	// cells are pushed in index order, so every pair is already (low, high); bodies sharing cells repeat
+	std::sort(pairs.begin(), pairs.end());
+	pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+}
@@ -0,0 +1,48 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: Broadphase.h
+Purpose: Prototype of spatial hash broadphase for softbody collisions
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#pragma once
+
+#ifndef BROADPHASE_H
+#define BROADPHASE_H
+
+#include "glm/glm.hpp"
+#include <vector>
+#include <unordered_map>
+#include <utility>
+
+// contact tolerance of IsCollidedPlane plus slack for particles moved after the bounds were taken
+#define BROADPHASE_MARGIN 0.25f
+// bodies covering more cells than this skip the grid and are tested against everyone
+#define BROADPHASE_MAX_CELLS 64
+
+class SoftBodyPhysics;
+
+class Broadphase {
+public:
+	// pairs (i, j) with i < j whose m_min / m_max boxes, grown by BROADPHASE_MARGIN, overlap.
+	// Sorted, so the narrowphase runs in the same order as the full pairwise loop.
+	void FindPairs(const std::vector<SoftBodyPhysics*>& bodies, std::vector<std::pair<unsigned, unsigned>>& pairs);
+	// the same over boxes given directly, without the margin
+	void FindPairs(const std::vector<glm::vec3>& min, const std::vector<glm::vec3>& max, std::vector<std::pair<unsigned, unsigned>>& pairs);
+private:
+	long long CellKey(int x, int y, int z) const;
+	// pairs of m_min / m_max
+	void FindBoxPairs(std::vector<std::pair<unsigned, unsigned>>& pairs);
+
+	std::unordered_map<long long, std::vector<unsigned>> m_cells;
+	std::vector<glm::vec3> m_min;
+	std::vector<glm::vec3> m_max;
+	std::vector<unsigned> m_oversized;
+};
+
+#endif
@@ -0,0 +1,178 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: FileUtil.cpp
+Purpose: Memory mapped files and the source stamps the on-disk caches check staleness with
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#include "FileUtil.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <sys/stat.h>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() : m_data(nullptr), m_size(0)
+{
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::Open(const char* path)
+{
+	Close();
+#if defined(_WIN32)
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size))
+	{
+		CloseHandle(file);
+		return false;
+	}
+	m_size = static_cast<size_t>(size.QuadPart);
+	// an empty file can't be mapped, it is just no data
+	if (m_size)
+	{
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping)
+		{
+			// the view keeps the mapping alive
+			m_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+			CloseHandle(mapping);
+		}
+	}
+	CloseHandle(file);
+#else
+	int file = open(path, O_RDONLY);
+	if (file < 0)
+		return false;
+	struct stat info;
+	if (fstat(file, &info) != 0)
+	{
+		close(file);
+		return false;
+	}
+	m_size = static_cast<size_t>(info.st_size);
+	if (m_size)
+	{
+		void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (data != MAP_FAILED)
+		{
+			madvise(data, m_size, MADV_SEQUENTIAL);
+			m_data = static_cast<const char*>(data);
+		}
+	}
+	close(file);
+#endif
+	if (m_size && !m_data)
+	{
+		m_size = 0;
+		return false;
+	}
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_data)
+	{
+#if defined(_WIN32)
+		UnmapViewOfFile(m_data);
+#else
+		munmap(const_cast<char*>(m_data), m_size);
+#endif
+	}
+	m_data = nullptr;
+	m_size = 0;
+}
+
+bool SourceStamp(const char* path, unsigned long long& size, long long& mtime)
+{
+#if defined(_WIN32)
+	struct _stat64 info;
+	if (_stat64(path, &info) != 0)
+		return false;
+#else
+	struct stat info;
+	if (stat(path, &info) != 0)
+		return false;
+#endif
+	size = static_cast<unsigned long long>(info.st_size);
+	mtime = static_cast<long long>(info.st_mtime);
+	return true;
+}
+bool HashSource(const char* path, unsigned long long& hash)
+{
+	MappedFile file;
+	if (!file.Open(path))
+		return false;
+	hash = 14695981039346656037ull;
+	const unsigned char* p = reinterpret_cast<const unsigned char*>(file.data());
+	for (size_t i = 0; i < file.size(); ++i)
+		hash = (hash ^ p[i]) * 1099511628211ull;
+	return true;
+}
+
+bool StampSources(const std::vector<std::string>& sources, unsigned long long& size, long long& mtime)
+{
+	bool found = false;
+	size = 0;
+	mtime = 0;
+	for (const std::string& source : sources)
+	{
+		unsigned long long source_size;
+		long long source_mtime;
+		if (!SourceStamp(source.c_str(), source_size, source_mtime))
+			continue;
+		size += source_size;
+		mtime = found ? std::max(mtime, source_mtime) : source_mtime;
+		found = true;
+	}
+	return found;
+}
+bool HashSources(const std::vector<std::string>& sources, unsigned long long& hash)
+{
+	hash = 0;
+	for (const std::string& source : sources)
+	{
+		unsigned long long size, source_hash;
+		long long mtime;
+		if (!SourceStamp(source.c_str(), size, mtime))
+			continue;
+		if (!HashSource(source.c_str(), source_hash))
+			return false;
+		hash = hash * 1099511628211ull ^ source_hash;
+	}
+	return true;
+}
+bool RestampCache(const char* path, size_t offset, long long mtime)
+{
+	FILE* file = fopen(path, "r+b");
+	if (!file)
+		return false;
+	bool written = fseek(file, static_cast<long>(offset), SEEK_SET) == 0 && fwrite(&mtime, sizeof(mtime), 1, file) == 1;
+	return fclose(file) == 0 && written;
+}
@@ -0,0 +1,52 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: FileUtil.h
+Purpose: Memory mapped files and the source stamps the on-disk caches check staleness with
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#pragma once
+
+#ifndef FILEUTIL_H
+#define FILEUTIL_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// read-only view of a whole file, unmapped on Close or destruction
+class MappedFile {
+public:
+	MappedFile();
+	~MappedFile();
+
+	bool Open(const char* path);
+	void Close();
+
+	const char* data() const { return m_data; }
+	size_t size() const { return m_size; }
+private:
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+
+	const char* m_data;
+	size_t m_size;
+};
+
+// size and mtime of a source file, and FNV-1a over its contents, what a cache checks staleness with
+bool SourceStamp(const char* path, unsigned long long& size, long long& mtime);
+bool HashSource(const char* path, unsigned long long& hash);
+// the same over several files: summed sizes and latest mtime of those that exist, false when none
+// does, and their hashes folded together, just the file's hash for one
+bool StampSources(const std::vector<std::string>& sources, unsigned long long& size, long long& mtime);
+bool HashSources(const std::vector<std::string>& sources, unsigned long long& hash);
+// overwrite the source mtime stored at offset in a cache whose source was touched but hashed the same,
+// so the next load doesn't hash it again. The cache must not be mapped while this writes it
+bool RestampCache(const char* path, size_t offset, long long mtime);
+
+#endif
@@ -0,0 +1,337 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: GpuSoftBody.cpp
+Purpose: Compute shader backend of a softbody
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#include "GpuSoftBody.h"
+#include "Base.h"
+#include "Shader.h"
+
+// velocity kept by Verlet, the same as SoftBodyPhysics::Verlet
+#define GPU_VERLET_DAMPING 0.99f
+
+namespace
+{
+	struct Programs {
+		Shader verlet;
+		Shader pin;
+		Shader distance;
+		Shader volume;
+		Shader collide;
+		Shader output;
+		Shader normals;
+		// what Step and Output set, looked up once the programs are linked
+		Shader::Uniform verlet_count, verlet_dt, verlet_damping, verlet_acceleration;
+		Shader::Uniform pin_count;
+		Shader::Uniform distance_factor, distance_first, distance_count;
+		Shader::Uniform volume_factor, volume_first, volume_count;
+		Shader::Uniform collide_count, collide_collider_count, collide_contact_depth;
+		Shader::Uniform output_count, output_alpha, output_position, output_scale;
+		Shader::Uniform normals_count;
+	};
+	Programs* programs = nullptr;
+
+	Programs& GetPrograms()
+	{
+		if (!programs)
+		{
+			programs = new Programs;
+			programs->verlet.CreateComputeShader("ShaderCodes\\softbody_verlet.cs");
+			programs->pin.CreateComputeShader("ShaderCodes\\softbody_pin.cs");
+			programs->distance.CreateComputeShader("ShaderCodes\\softbody_distance.cs");
+			programs->volume.CreateComputeShader("ShaderCodes\\softbody_volume.cs");
+			programs->collide.CreateComputeShader("ShaderCodes\\softbody_collide.cs");
+			programs->output.CreateComputeShader("ShaderCodes\\softbody_output.cs");
+			programs->normals.CreateComputeShader("ShaderCodes\\softbody_normals.cs");
+
+			programs->verlet_count = programs->verlet.GetUniform("count");
+			programs->verlet_dt = programs->verlet.GetUniform("dt");
+			programs->verlet_damping = programs->verlet.GetUniform("damping");
+			programs->verlet_acceleration = programs->verlet.GetUniform("acceleration");
+			programs->pin_count = programs->pin.GetUniform("count");
+			programs->distance_factor = programs->distance.GetUniform("factor");
+			programs->distance_first = programs->distance.GetUniform("first");
+			programs->distance_count = programs->distance.GetUniform("count");
+			programs->volume_factor = programs->volume.GetUniform("factor");
+			programs->volume_first = programs->volume.GetUniform("first");
+			programs->volume_count = programs->volume.GetUniform("count");
+			programs->collide_count = programs->collide.GetUniform("count");
+			programs->collide_collider_count = programs->collide.GetUniform("collider_count");
+			programs->collide_contact_depth = programs->collide.GetUniform("contact_depth");
+			programs->output_count = programs->output.GetUniform("count");
+			programs->output_alpha = programs->output.GetUniform("alpha");
+			programs->output_position = programs->output.GetUniform("position");
+			programs->output_scale = programs->output.GetUniform("scale");
+			programs->normals_count = programs->normals.GetUniform("count");
+		}
+		return *programs;
+	}
+
+	void Dispatch(unsigned count)
+	{
+		glDispatchCompute((count + GPU_GROUP_SIZE - 1) / GPU_GROUP_SIZE, 1, 1);
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+	}
+
+	unsigned CreateStorage(GLsizeiptr size, const void* data)
+	{
+		unsigned buffer = 0;
+		glGenBuffers(1, &buffer);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+		// zero sized buffers can't be bound, keep at least one element around
+		glBufferData(GL_SHADER_STORAGE_BUFFER, size > 0 ? size : 16, size > 0 ? data : nullptr, GL_DYNAMIC_DRAW);
+		return buffer;
+	}
+
+	unsigned CreateIndexStorage(const std::vector<unsigned>& values)
+	{
+		return CreateStorage(values.size() * sizeof(unsigned), values.empty() ? nullptr : &values[0]);
+	}
+
+	void ToVec4(const ParticleArray& particles, std::vector<glm::vec4>& out)
+	{
+		out.resize(particles.size());
+		for (unsigned i = 0; i < particles.size(); ++i)
+			out[i] = glm::vec4(particles.get(i), 0.f);
+	}
+}
+
+GpuSoftBody::GpuSoftBody()
+	: m_pos(0), m_old(0), m_distance(0), m_volume(0), m_pins(0), m_colliders(0),
+	m_faces(0), m_face_start(0), m_vertex_faces(0), m_weld(0), m_anchor(0), m_anchor_fence(nullptr),
+	m_collider_capacity(0), m_anchors(), m_particles(0), m_pin_count(0), m_vbo(0), m_normal_buffer(0), m_vertex_count(0)
+{
+}
+
+GpuSoftBody::~GpuSoftBody()
+{
+	unsigned buffers[] = { m_pos, m_old, m_distance, m_volume, m_pins, m_colliders, m_faces, m_face_start, m_vertex_faces, m_weld, m_anchor };
+	for (unsigned buffer : buffers)
+		if (buffer)
+			glDeleteBuffers(1, &buffer);
+	if (m_anchor_fence)
+		glDeleteSync(static_cast<GLsync>(m_anchor_fence));
+}
+
+bool GpuSoftBody::Supported()
+{
+	return !Object::headless && GLAD_GL_VERSION_4_3;
+}
+
+void GpuSoftBody::ShutDown()
+{
+	delete programs;
+	programs = nullptr;
+}
+
+void GpuSoftBody::BuildColliders(const std::vector<Object*>& rigid, std::vector<GpuCollider>& colliders)
+{
+	colliders.clear();
+	for (Object* obj : rigid)
+	{
+		GpuCollider collider = {};
+		if (obj->m_shape == O_SPHERE)
+		{
+			collider.kind = GPU_COLLIDER_SPHERE;
+			collider.sphere = glm::vec4(obj->position, obj->scale.x + 0.01f);
+		}
+		else if (obj->m_shape == O_PLANE)
+		{
+			int last = static_cast<int>(obj->obj_vertices.size()) - 1;
+			glm::vec3 point0 = obj->m_model * glm::vec4(obj->obj_vertices[0], 1.f);
+			glm::vec3 point1 = obj->m_model * glm::vec4(obj->obj_vertices[last], 1.f);
+			glm::vec3 point2 = obj->m_model * glm::vec4(obj->obj_vertices[1], 1.f);
+			glm::vec3 normal = glm::normalize(glm::cross(point1 - point0, point2 - point0));
+
+			collider.kind = GPU_COLLIDER_PLANE;
+			collider.plane = glm::vec4(normal, -glm::dot(normal, point0));
+			collider.box_min = glm::vec4(glm::min(point0, point1), 0.f);
+			collider.box_max = glm::vec4(glm::max(point0, point1), 0.f);
+		}
+		else
+			continue;
+		colliders.push_back(collider);
+	}
+}
+
+void GpuSoftBody::Upload(const GpuSoftBodyData& data)
+{
+	static_assert(sizeof(constraints) == 3 * sizeof(int), "softbody_distance.cs reads constraints as int, int, float");
+	static_assert(sizeof(volume_constraints) == 6 * sizeof(int), "softbody_volume.cs reads volume_constraints as 4 int, 2 float");
+	static_assert(sizeof(GpuCollider) == 80 && sizeof(GpuPin) == 16, "std430 layout of the collide and pin shaders");
+
+	std::vector<glm::vec4> particles;
+	m_particles = data.pos->size();
+	ToVec4(*data.pos, particles);
+	m_pos = CreateStorage(particles.size() * sizeof(glm::vec4), &particles[0]);
+	ToVec4(*data.old, particles);
+	m_old = CreateStorage(particles.size() * sizeof(glm::vec4), &particles[0]);
+
+	m_distance = CreateStorage(data.distance->size() * sizeof(constraints), data.distance->empty() ? nullptr : &(*data.distance)[0]);
+	m_volume = CreateStorage(data.volume->size() * sizeof(volume_constraints), data.volume->empty() ? nullptr : &(*data.volume)[0]);
+	m_distance_batches = *data.distance_batches;
+	m_volume_batches = *data.volume_batches;
+
+	m_pin_count = static_cast<unsigned>(data.pins.size());
+	m_pins = CreateStorage(data.pins.size() * sizeof(GpuPin), data.pins.empty() ? nullptr : &data.pins[0]);
+
+	m_faces = CreateIndexStorage(*data.faces);
+	m_face_start = CreateIndexStorage(*data.face_start);
+	m_vertex_faces = CreateIndexStorage(*data.vertex_faces);
+	m_weld = CreateIndexStorage(*data.weld);
+
+	m_anchor = CreateStorage(6 * sizeof(glm::vec4), nullptr);
+	for (unsigned i = 0; i < 6; ++i)
+		m_anchors[i] = data.anchors[i];
+
+	m_vbo = data.vbo;
+	m_normal_buffer = data.normal_buffer;
+	m_vertex_count = data.vertex_count;
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void GpuSoftBody::Step(float dt, const glm::vec3& acceleration, float factor, unsigned iterations, const std::vector<GpuCollider>& colliders)
+{
+	Programs& p = GetPrograms();
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_pos);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_old);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_distance);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_volume);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, m_pins);
+
+	p.verlet.Use();
+	p.verlet.SetInt(p.verlet_count, m_particles);
+	p.verlet.SetFloat(p.verlet_dt, dt);
+	p.verlet.SetFloat(p.verlet_damping, GPU_VERLET_DAMPING);
+	p.verlet.SetVec3(p.verlet_acceleration, acceleration);
+	Dispatch(m_particles);
+
+	// every color batch is its own dispatch, the barrier between them orders the batches like the CPU loop
+	for (unsigned i = 0; i < iterations; ++i)
+	{
+		if (m_pin_count)
+		{
+			p.pin.Use();
+			p.pin.SetInt(p.pin_count, m_pin_count);
+			Dispatch(m_pin_count);
+		}
+
+		p.distance.Use();
+		p.distance.SetFloat(p.distance_factor, factor);
+		for (unsigned c = 0; c + 1 < m_distance_batches.size(); ++c)
+		{
+			unsigned count = m_distance_batches[c + 1] - m_distance_batches[c];
+			p.distance.SetInt(p.distance_first, m_distance_batches[c]);
+			p.distance.SetInt(p.distance_count, count);
+			Dispatch(count);
+		}
+
+		p.volume.Use();
+		p.volume.SetFloat(p.volume_factor, factor);
+		for (unsigned c = 0; c + 1 < m_volume_batches.size(); ++c)
+		{
+			unsigned count = m_volume_batches[c + 1] - m_volume_batches[c];
+			p.volume.SetInt(p.volume_first, m_volume_batches[c]);
+			p.volume.SetInt(p.volume_count, count);
+			Dispatch(count);
+		}
+	}
+
+	if (colliders.empty())
+		return;
+	if (!m_colliders)
+		glGenBuffers(1, &m_colliders);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_colliders);
+	// only grows, the same rigid bodies come back every step
+	if (colliders.size() > m_collider_capacity)
+	{
+		m_collider_capacity = static_cast<unsigned>(colliders.size());
+		glBufferData(GL_SHADER_STORAGE_BUFFER, m_collider_capacity * sizeof(GpuCollider), nullptr, GL_DYNAMIC_DRAW);
+	}
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, colliders.size() * sizeof(GpuCollider), &colliders[0]);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, m_colliders);
+
+	p.collide.Use();
+	p.collide.SetInt(p.collide_count, m_particles);
+	p.collide.SetInt(p.collide_collider_count, static_cast<int>(colliders.size()));
+	p.collide.SetFloat(p.collide_contact_depth, CONTACT_DEPTH);
+	Dispatch(m_particles);
+}
+
+void GpuSoftBody::Output(float alpha, const glm::vec3& position, const glm::vec3& scale)
+{
+	Programs& p = GetPrograms();
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_pos);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_old);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_vbo);
+	p.output.Use();
+	p.output.SetInt(p.output_count, m_vertex_count);
+	p.output.SetFloat(p.output_alpha, alpha);
+	p.output.SetVec3(p.output_position, position);
+	p.output.SetVec3(p.output_scale, scale);
+	Dispatch(m_vertex_count);
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_vbo);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_normal_buffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_faces);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_face_start);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, m_vertex_faces);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, m_weld);
+	p.normals.Use();
+	p.normals.SetInt(p.normals_count, m_vertex_count);
+	glDispatchCompute((m_vertex_count + GPU_GROUP_SIZE - 1) / GPU_GROUP_SIZE, 1, 1);
+	glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+
+	// the anchors go to a small buffer the CPU reads once the copy is done, a frame or so later
+	if (!m_anchor_fence)
+	{
+		glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+		glBindBuffer(GL_COPY_READ_BUFFER, m_pos);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, m_anchor);
+		for (unsigned i = 0; i < 6; ++i)
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, m_anchors[i] * sizeof(glm::vec4), i * sizeof(glm::vec4), sizeof(glm::vec4));
+		m_anchor_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+	glUseProgram(0);
+}
+
+bool GpuSoftBody::ReadAnchors(glm::vec3& center)
+{
+	if (!m_anchor_fence)
+		return false;
+	GLenum status = glClientWaitSync(static_cast<GLsync>(m_anchor_fence), 0, 0);
+	if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+		return false;
+	glDeleteSync(static_cast<GLsync>(m_anchor_fence));
+	m_anchor_fence = nullptr;
+
+	glm::vec4 anchors[6];
+	glBindBuffer(GL_COPY_READ_BUFFER, m_anchor);
+	glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(anchors), anchors);
+	center = glm::vec3(0.f);
+	for (unsigned i = 0; i < 6; ++i)
+		center += glm::vec3(anchors[i]);
+	center /= 6.f;
+	return true;
+}
+
+void GpuSoftBody::ReadBack(ParticleArray& pos, ParticleArray& old) const
+{
+	glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+	std::vector<glm::vec4> particles(m_particles);
+	glBindBuffer(GL_COPY_READ_BUFFER, m_pos);
+	glGetBufferSubData(GL_COPY_READ_BUFFER, 0, particles.size() * sizeof(glm::vec4), &particles[0]);
+	for (unsigned i = 0; i < m_particles; ++i)
+		pos.set(i, glm::vec3(particles[i]));
+	glBindBuffer(GL_COPY_READ_BUFFER, m_old);
+	glGetBufferSubData(GL_COPY_READ_BUFFER, 0, particles.size() * sizeof(glm::vec4), &particles[0]);
+	for (unsigned i = 0; i < m_particles; ++i)
+		old.set(i, glm::vec3(particles[i]));
+}
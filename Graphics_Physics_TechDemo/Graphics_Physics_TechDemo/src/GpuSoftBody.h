@@ -0,0 +1,110 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: GpuSoftBody.h
+Purpose: Compute shader backend of a softbody, particles and constraints live in SSBOs
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#pragma once
+
+#ifndef GPU_SOFTBODY_H
+#define GPU_SOFTBODY_H
+
+#include "Particle.h"
+#include "glm/glm.hpp"
+#include <vector>
+
+// local_size_x of ShaderCodes\softbody_*.cs
+#define GPU_GROUP_SIZE 128
+
+#define GPU_COLLIDER_SPHERE 0
+#define GPU_COLLIDER_PLANE 1
+
+class Object;
+struct constraints;
+struct volume_constraints;
+
+// a rigid body as softbody_collide.cs reads it, std430 layout
+struct GpuCollider {
+	glm::vec4 sphere;	// center, radius
+	glm::vec4 plane;	// normal, d
+	glm::vec4 box_min;	// bounds of the plane's point0 / point1
+	glm::vec4 box_max;
+	int kind;
+	int pad[3];
+};
+
+// a particle held in place every constraint iteration, std430 layout
+struct GpuPin {
+	glm::vec3 position;
+	int index;
+};
+
+struct GpuSoftBodyData {
+	const ParticleArray* pos;
+	const ParticleArray* old;
+	const std::vector<constraints>* distance;
+	const std::vector<unsigned>* distance_batches;
+	const std::vector<volume_constraints>* volume;
+	const std::vector<unsigned>* volume_batches;
+	std::vector<GpuPin> pins;
+	// Object::BuildNormalAdjacency output
+	const std::vector<unsigned>* faces;
+	const std::vector<unsigned>* face_start;
+	const std::vector<unsigned>* vertex_faces;
+	const std::vector<unsigned>* weld;
+	// the particles Update averages into position
+	unsigned anchors[6];
+	// render buffers, vertices are the particles but the trailing center point
+	unsigned vbo;
+	unsigned normal_buffer;
+	unsigned vertex_count;
+};
+
+class GpuSoftBody {
+public:
+	GpuSoftBody();
+	~GpuSoftBody();
+
+	// compute shaders need a GL 4.3 context
+	static bool Supported();
+	// delete the shared programs while the context is still alive
+	static void ShutDown();
+	// the planes and spheres of CollisionResponseRigid, rigid m_model has to be current
+	static void BuildColliders(const std::vector<Object*>& rigid, std::vector<GpuCollider>& colliders);
+
+	void Upload(const GpuSoftBodyData& data);
+	// Verlet, KeepConstraint and the rigid contacts of one step, all on the GPU
+	void Step(float dt, const glm::vec3& acceleration, float factor, unsigned iterations, const std::vector<GpuCollider>& colliders);
+	// write the interpolated vertices and their normals to the render buffers
+	void Output(float alpha, const glm::vec3& position, const glm::vec3& scale);
+	// average of the anchors copied by an earlier Output, false while that copy is still in flight
+	bool ReadAnchors(glm::vec3& center);
+	// particles back to the CPU, stalls until the GPU is done
+	void ReadBack(ParticleArray& pos, ParticleArray& old) const;
+
+private:
+	GpuSoftBody(const GpuSoftBody&);
+	GpuSoftBody& operator=(const GpuSoftBody&);
+
+	unsigned m_pos, m_old;
+	unsigned m_distance, m_volume, m_pins, m_colliders;
+	unsigned m_faces, m_face_start, m_vertex_faces, m_weld;
+	unsigned m_anchor;
+	void* m_anchor_fence;
+	unsigned m_collider_capacity;
+
+	std::vector<unsigned> m_distance_batches;
+	std::vector<unsigned> m_volume_batches;
+	unsigned m_anchors[6];
+	unsigned m_particles;
+	unsigned m_pin_count;
+	unsigned m_vbo, m_normal_buffer, m_vertex_count;
+};
+
+#endif
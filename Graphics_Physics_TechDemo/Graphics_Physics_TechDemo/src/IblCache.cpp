@@ -0,0 +1,138 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: IblCache.cpp
+Purpose: Versioned cache of the precomputed IBL textures, read back once and uploaded as is
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#include "glad/glad.h"
+#include "IblCache.h"
+#include "FileUtil.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+#define IBL_CACHE_MAGIC "GPIB"
+
+static_assert(sizeof(IblCacheHeader) % 8 == 0, "levels follow the header aligned");
+
+namespace
+{
+	unsigned Faces(unsigned target)
+	{
+		return target == GL_TEXTURE_CUBE_MAP ? 6 : 1;
+	}
+	unsigned Channels(unsigned format)
+	{
+		return format == GL_RG16F ? 2 : 3;
+	}
+	// one face of a level in half floats
+	size_t FaceSize(const IblCache::Layout& layout, const IblCacheLevel& level)
+	{
+		return static_cast<size_t>(level.size) * level.size * Channels(layout.format) * sizeof(unsigned short);
+	}
+	size_t CacheSize(const IblCache::Layout& layout)
+	{
+		size_t size = sizeof(IblCacheHeader);
+		for (const IblCacheLevel& level : layout.levels)
+			size += FaceSize(layout, level) * Faces(layout.target);
+		return size;
+	}
+	unsigned FaceTarget(unsigned target, unsigned face)
+	{
+		return target == GL_TEXTURE_CUBE_MAP ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face : target;
+	}
+}
+
+bool IblCache::Load(const std::string& path, const std::vector<std::string>& sources, const Layout& layout, const unsigned* textures)
+{
+	unsigned long long size;
+	long long mtime;
+	MappedFile file;
+	if (layout.levels.size() > IBL_CACHE_MAX_LEVELS || !StampSources(sources, size, mtime) || !file.Open(path.c_str()))
+		return false;
+	if (file.size() != CacheSize(layout))
+		return false;
+
+	const IblCacheHeader& h = *reinterpret_cast<const IblCacheHeader*>(file.data());
+	bool valid = !memcmp(h.magic, IBL_CACHE_MAGIC, sizeof(h.magic)) && h.version == IBL_CACHE_VERSION
+		&& h.target == layout.target && h.format == layout.format && h.level_count == layout.levels.size() && h.source_size == size;
+	for (unsigned i = 0; valid && i < h.level_count; ++i)
+		valid = h.levels[i].texture == layout.levels[i].texture && h.levels[i].level == layout.levels[i].level
+			&& h.levels[i].size == layout.levels[i].size;
+	// a touched but unchanged HDR (checkout, copy) still matches by content
+	unsigned long long hash;
+	bool touched = valid && h.source_mtime != mtime;
+	if (touched)
+		valid = HashSources(sources, hash) && hash == h.source_hash;
+	if (!valid)
+		return false;
+
+	const char* pixels = file.data() + sizeof(IblCacheHeader);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	for (const IblCacheLevel& level : layout.levels)
+	{
+		glBindTexture(layout.target, textures[level.texture]);
+		for (unsigned face = 0; face < Faces(layout.target); ++face)
+		{
+			glTexSubImage2D(FaceTarget(layout.target, face), level.level, 0, 0, level.size, level.size,
+				layout.format == GL_RG16F ? GL_RG : GL_RGB, GL_HALF_FLOAT, pixels);
+			pixels += FaceSize(layout, level);
+		}
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	// take the new mtime so only the first load after the touch hashes the HDR
+	if (touched)
+	{
+		file.Close();
+		RestampCache(path.c_str(), offsetof(IblCacheHeader, source_mtime), mtime);
+	}
+	return true;
+}
+bool IblCache::Write(const std::string& path, const std::vector<std::string>& sources, const Layout& layout, const unsigned* textures)
+{
+	if (layout.levels.size() > IBL_CACHE_MAX_LEVELS)
+		return false;
+	IblCacheHeader header = {};
+	memcpy(header.magic, IBL_CACHE_MAGIC, sizeof(header.magic));
+	header.version = IBL_CACHE_VERSION;
+	if (!StampSources(sources, header.source_size, header.source_mtime) || !HashSources(sources, header.source_hash))
+		return false;
+	header.target = layout.target;
+	header.format = layout.format;
+	header.level_count = static_cast<unsigned>(layout.levels.size());
+	for (unsigned i = 0; i < header.level_count; ++i)
+		header.levels[i] = layout.levels[i];
+
+	// one blocking read back on the run that builds the cache, every later run skips the render
+	std::vector<char> bytes(CacheSize(layout));
+	memcpy(&bytes[0], &header, sizeof(header));
+	char* pixels = &bytes[sizeof(header)];
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	for (const IblCacheLevel& level : layout.levels)
+	{
+		glBindTexture(layout.target, textures[level.texture]);
+		for (unsigned face = 0; face < Faces(layout.target); ++face)
+		{
+			glGetTexImage(FaceTarget(layout.target, face), level.level, layout.format == GL_RG16F ? GL_RG : GL_RGB, GL_HALF_FLOAT, pixels);
+			pixels += FaceSize(layout, level);
+		}
+	}
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+	FILE* file = fopen(path.c_str(), "wb");
+	if (!file)
+		return false;
+	bool written = fwrite(&bytes[0], bytes.size(), 1, file) == 1;
+	written = fclose(file) == 0 && written;
+	// a partial file would fail the size check anyway, don't leave it around
+	if (!written)
+		remove(path.c_str());
+	return written;
+}
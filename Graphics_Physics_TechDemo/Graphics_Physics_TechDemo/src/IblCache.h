@@ -0,0 +1,66 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: IblCache.h
+Purpose: Versioned cache of the precomputed IBL textures, read back once and uploaded as is
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#pragma once
+
+#ifndef IBLCACHE_H
+#define IBLCACHE_H
+
+#include <string>
+#include <vector>
+
+// bump whenever IblCacheHeader or what InitFrameBuffer renders changes outside the shaders
+#define IBL_CACHE_VERSION 1
+// written next to the first source, newport_loft.hdr -> newport_loft.hdr.ibl
+#define IBL_CACHE_EXTENSION ".ibl"
+#define IBL_CACHE_MAX_LEVELS 8
+
+// one stored mip level of one of the cached textures, square
+struct IblCacheLevel {
+	unsigned texture;	// index into the textures Load and Write take
+	unsigned level;
+	unsigned size;
+};
+
+// file layout: header, then each level's faces as half floats in the order of levels
+struct IblCacheHeader {
+	char magic[4];
+	unsigned version;
+	// the HDR and the shaders the textures were rendered from, the hash is only checked when the mtime differs
+	unsigned long long source_size;
+	long long source_mtime;
+	unsigned long long source_hash;
+	// GL_TEXTURE_CUBE_MAP or GL_TEXTURE_2D, GL_RGB16F or GL_RG16F
+	unsigned target;
+	unsigned format;
+	unsigned level_count;
+	IblCacheLevel levels[IBL_CACHE_MAX_LEVELS];
+	unsigned reserved[3];
+};
+
+class IblCache {
+public:
+	// what a cache holds, it only matches a file with the same layout
+	struct Layout {
+		unsigned target;
+		unsigned format;
+		std::vector<IblCacheLevel> levels;
+	};
+
+	// fills the levels of the already allocated textures from the cache at path, false when it is missing,
+	// truncated, another version or layout, or stale
+	static bool Load(const std::string& path, const std::vector<std::string>& sources, const Layout& layout, const unsigned* textures);
+	// reads the levels of textures back and writes them to path, false and nothing written if that fails
+	static bool Write(const std::string& path, const std::vector<std::string>& sources, const Layout& layout, const unsigned* textures);
+};
+
+#endif
@@ -0,0 +1,105 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: InstanceRenderer.cpp
+Purpose: Repeated built-in shapes drawn as one instanced draw per mesh
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#include "glad/glad.h"
+#include "InstanceRenderer.h"
+#include "Shader.h"
+
+InstanceRenderer::InstanceRenderer() : m_buffer(0), m_capacity(0), m_dirty(false)
+{
+}
+InstanceRenderer::~InstanceRenderer()
+{
+	Clear();
+}
+void InstanceRenderer::Add(ObjectShape shape, int dimension, const glm::mat4& model, const glm::vec4& params)
+{
+	Object* mesh = Mesh(shape, dimension);
+
+	Batch* batch = nullptr;
+	for (Batch& b : m_batches)
+		if (b.mesh == mesh)
+		{
+			batch = &b;
+			break;
+		}
+	if (!batch)
+	{
+		m_batches.push_back(Batch());
+		batch = &m_batches.back();
+		batch->mesh = mesh;
+	}
+	InstanceData instance;
+	instance.model = model;
+	instance.params = params;
+	batch->instances.push_back(instance);
+	m_dirty = true;
+}
+void InstanceRenderer::Draw(Shader* shader, unsigned mode)
+{
+	if (m_batches.empty())
+		return;
+	if (m_dirty)
+	{
+		std::vector<InstanceData> all;
+		for (const Batch& batch : m_batches)
+			all.insert(all.end(), batch.instances.begin(), batch.instances.end());
+		if (!m_buffer)
+			glGenBuffers(1, &m_buffer);
+		glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+		if (all.size() > m_capacity)
+		{
+			m_capacity = all.size();
+			glBufferData(GL_ARRAY_BUFFER, m_capacity * sizeof(InstanceData), &all[0], GL_DYNAMIC_DRAW);
+		}
+		else if (!all.empty())
+		{
+			// orphan first so a rewrite every frame doesn't wait on the last frame's draws
+			glBufferData(GL_ARRAY_BUFFER, m_capacity * sizeof(InstanceData), nullptr, GL_DYNAMIC_DRAW);
+			glBufferSubData(GL_ARRAY_BUFFER, 0, all.size() * sizeof(InstanceData), &all[0]);
+		}
+		m_dirty = false;
+	}
+
+	unsigned first = 0;
+	for (const Batch& batch : m_batches)
+	{
+		unsigned count = static_cast<unsigned>(batch.instances.size());
+		batch.mesh->render_instances(shader, m_buffer, first, count, mode);
+		first += count;
+	}
+}
+void InstanceRenderer::ClearInstances()
+{
+	for (Batch& batch : m_batches)
+		batch.instances.clear();
+	m_dirty = true;
+}
+void InstanceRenderer::Clear()
+{
+	m_batches.clear();
+	for (auto& mesh : m_meshes)
+		delete mesh.second;
+	m_meshes.clear();
+	if (m_buffer)
+		glDeleteBuffers(1, &m_buffer);
+	m_buffer = 0;
+	m_capacity = 0;
+	m_dirty = false;
+}
+Object* InstanceRenderer::Mesh(ObjectShape shape, int dimension)
+{
+	Object*& mesh = m_meshes[std::make_pair(static_cast<int>(shape), dimension)];
+	if (!mesh)
+		mesh = new Object(shape, glm::vec3(0.f), glm::vec3(1.f), dimension);
+	return mesh;
+}
@@ -0,0 +1,58 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: InstanceRenderer.h
+Purpose: Repeated built-in shapes drawn as one instanced draw per mesh
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#pragma once
+
+#ifndef INSTANCERENDERER_H
+#define INSTANCERENDERER_H
+
+#include "Object.h"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+class InstanceRenderer {
+public:
+	InstanceRenderer();
+	~InstanceRenderer();
+
+	// one copy of shape at model; copies of the same shape and dimension share one draw,
+	// the material layer goes in params.z for pbr_texture.fs
+	void Add(ObjectShape shape, int dimension, const glm::mat4& model, const glm::vec4& params);
+	// uploads the instances if they changed since the last Draw, then one draw per batch
+	void Draw(Shader* shader, unsigned mode);
+	// drop the instances but keep the meshes and the buffer for the next Add
+	void ClearInstances();
+	void Clear();
+
+	size_t BatchCount() const { return m_batches.size(); }
+private:
+	InstanceRenderer(const InstanceRenderer&);
+	InstanceRenderer& operator=(const InstanceRenderer&);
+
+	struct Batch {
+		Object* mesh;
+		std::vector<InstanceData> instances;
+	};
+
+	// one vao per shape and dimension, shared by every batch of it
+	Object* Mesh(ObjectShape shape, int dimension);
+
+	std::map<std::pair<int, int>, Object*> m_meshes;
+	std::vector<Batch> m_batches;
+	unsigned m_buffer;
+	size_t m_capacity;
+	bool m_dirty;
+};
+
+#endif
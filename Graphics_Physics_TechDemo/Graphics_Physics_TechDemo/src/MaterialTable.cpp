@@ -0,0 +1,285 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: MaterialTable.cpp
+Purpose: Every PBR texture set in one texture array per map, indexed by TextureType
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#include "glad/glad.h"
+#include "MaterialTable.h"
+#include "..\include\stb_image.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace
+{
+	// directory of each TextureType under models\pbr
+	const char* const material_dirs[MATERIAL_COUNT] = {
+		"plastic", "steel", "Wood", "rusted-iron", "Fabric", "TornFabric",
+		"Aluminium", "Copper", "Concrete", "Leather", "gold"
+	};
+	// the orm map packs ao, roughness and metallic into r, g and b, one fetch for all three
+	const char* const map_files[MATERIAL_MAPS][3] = {
+		{ "Sphere3D_1_defaultMat_BaseColor.png" },
+		{ "Sphere3D_1_defaultMat_Normal.png" },
+		{ "ao.png", "Sphere3D_1_defaultMat_Roughness.png", "Sphere3D_1_defaultMat_Metallic.png" }
+	};
+	// packed maps have no single image to sit next to
+	const char* const packed_caches[MATERIAL_MAPS] = { nullptr, nullptr, "orm" TEXTURE_CACHE_EXTENSION };
+	// BC1 albedo, BC5 normal x and y, BC7 keeps the three orm channels apart where BC1 would blend them
+	const unsigned map_formats[MATERIAL_MAPS] = {
+		GL_COMPRESSED_RGB_S3TC_DXT1_EXT, GL_COMPRESSED_RG_RGTC2, GL_COMPRESSED_RGBA_BPTC_UNORM
+	};
+	// what a layer shows until its files are in: grey, flat normal, no occlusion, half rough and dielectric
+	const unsigned char placeholders[MATERIAL_MAPS][3] = {
+		{ 128, 128, 128 }, { 128, 128, 255 }, { 255, 128, 0 }
+	};
+	const unsigned char black[3] = { 0, 0, 0 };
+	const unsigned material_images = MATERIAL_MAPS * MATERIAL_COUNT;
+
+	std::string MaterialDir(int layer)
+	{
+		return std::string("models\\pbr\\") + material_dirs[layer] + "\\";
+	}
+	TextureCache::Sources MaterialSources(unsigned map, int layer)
+	{
+		TextureCache::Sources sources;
+		for (const char* file : map_files[map])
+			if (file)
+				sources.push_back(MaterialDir(layer) + file);
+		return sources;
+	}
+	std::string MaterialCachePath(unsigned map, int layer)
+	{
+		if (packed_caches[map])
+			return MaterialDir(layer) + packed_caches[map];
+		return TextureCache::CachePath(MaterialSources(map, layer)[0].c_str());
+	}
+}
+
+MaterialTable::MaterialTable() : m_remaining(0), m_pbo(0), m_next(0)
+{
+	for (unsigned i = 0; i < MATERIAL_MAPS; ++i)
+	{
+		m_arrays[i] = 0;
+		m_format[i] = 0;
+		m_width[i] = m_height[i] = m_levels[i] = 0;
+		m_pending[i] = 0;
+	}
+}
+MaterialTable::~MaterialTable()
+{
+	Delete();
+}
+void MaterialTable::Load()
+{
+	if (Loaded())
+		return;
+	glGenTextures(MATERIAL_MAPS, m_arrays);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	for (unsigned map = 0; map < MATERIAL_MAPS; ++map)
+	{
+		m_format[map] = map_formats[map];
+		// BC1 is an extension, albedo stays uncompressed on a driver without it
+		if (m_format[map] == GL_COMPRESSED_RGB_S3TC_DXT1_EXT && !GLAD_GL_EXT_texture_compression_s3tc)
+			m_format[map] = GL_RGB8;
+
+		// every layer has the size of the first material with a readable header, the largest of its
+		// files for a packed map. A layer that differs stays black
+		int width = 0, height = 0;
+		for (int layer = 0; layer < MATERIAL_COUNT && !width; ++layer)
+			for (const std::string& source : MaterialSources(map, layer))
+			{
+				int file_width, file_height, nrChannels;
+				if (stbi_info(source.c_str(), &file_width, &file_height, &nrChannels))
+				{
+					width = std::max(width, file_width);
+					height = std::max(height, file_height);
+				}
+			}
+		if (!width)
+			width = height = 1;
+		m_width[map] = static_cast<unsigned>(width);
+		m_height[map] = static_cast<unsigned>(height);
+		m_levels[map] = TextureCache::LevelCount(m_width[map], m_height[map]);
+
+		glBindTexture(GL_TEXTURE_2D_ARRAY, m_arrays[map]);
+		glTexStorage3D(GL_TEXTURE_2D_ARRAY, m_levels[map], m_format[map], width, height, MATERIAL_COUNT);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+		// only the 1x1 level is sampled until every layer is in, so only it needs the placeholder
+		unsigned last = m_levels[map] - 1;
+		std::vector<unsigned char> fill;
+		TextureCache::Fill(m_format[map], 1, 1, placeholders[map], fill);
+		for (int layer = 0; layer < MATERIAL_COUNT; ++layer)
+			SubImage(map, last, layer, 1, &fill[0], fill.size());
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BASE_LEVEL, last);
+		m_pending[map] = MATERIAL_COUNT;
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	m_remaining = material_images;
+	glGenBuffers(1, &m_pbo);
+
+	// the main thread keeps rendering, the rest of the cores decode
+	unsigned cores = std::thread::hardware_concurrency();
+	unsigned threads = std::min(cores > 1 ? cores - 1 : 1, material_images);
+	m_next = 0;
+	for (unsigned i = 0; i < threads; ++i)
+		m_workers.push_back(std::thread(&MaterialTable::DecodeLoop, this));
+}
+void MaterialTable::Update()
+{
+	if (!m_remaining)
+		return;
+	std::vector<Decoded> finished;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		size_t count = std::min(m_ready.size(), static_cast<size_t>(MATERIAL_UPLOADS_PER_FRAME));
+		finished.assign(m_ready.begin(), m_ready.begin() + count);
+		m_ready.erase(m_ready.begin(), m_ready.begin() + count);
+	}
+	if (finished.empty())
+		return;
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	for (const Decoded& image : finished)
+		Upload(image);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	if (!m_remaining)
+		StopWorkers();
+}
+void MaterialTable::Delete()
+{
+	if (!Loaded())
+		return;
+	StopWorkers();
+	for (const Decoded& image : m_ready)
+		delete image.cache;
+	m_ready.clear();
+	glDeleteTextures(MATERIAL_MAPS, m_arrays);
+	glDeleteBuffers(1, &m_pbo);
+	m_pbo = 0;
+	m_remaining = 0;
+	for (unsigned i = 0; i < MATERIAL_MAPS; ++i)
+	{
+		m_arrays[i] = 0;
+		m_pending[i] = 0;
+	}
+}
+void MaterialTable::Bind() const
+{
+	for (unsigned i = 0; i < MATERIAL_MAPS; ++i)
+	{
+		glActiveTexture(GL_TEXTURE0 + MATERIAL_TEXTURE_UNIT + i);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, m_arrays[i]);
+	}
+}
+void MaterialTable::DecodeLoop()
+{
+	// material by material, so a whole set swaps in together
+	for (unsigned job = m_next++; job < material_images; job = m_next++)
+	{
+		Decoded image;
+		image.layer = static_cast<int>(job / MATERIAL_MAPS);
+		image.map = job % MATERIAL_MAPS;
+		image.cache = new TextureCache;
+		std::string path = MaterialCachePath(image.map, image.layer);
+		TextureCache::Sources sources = MaterialSources(image.map, image.layer);
+		// the first run decodes, packs and compresses, later runs only map the cache
+		if (!image.cache->Open(path, sources, m_format[image.map]) && !image.cache->Build(path, sources, m_format[image.map]))
+		{
+			delete image.cache;
+			image.cache = nullptr;
+		}
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_ready.push_back(image);
+	}
+}
+void MaterialTable::Upload(const Decoded& image)
+{
+	const unsigned map = image.map;
+	glBindTexture(GL_TEXTURE_2D_ARRAY, m_arrays[map]);
+	if (image.cache && image.cache->header().width == m_width[map] && image.cache->header().height == m_height[map])
+	{
+		GLsizeiptr size = static_cast<GLsizeiptr>(image.cache->levels_size());
+		// orphaned each time so the copy never waits on the previous transfer
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+		void* pixels = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+		const unsigned char* data = image.cache->levels();
+		if (pixels)
+		{
+			memcpy(pixels, data, static_cast<size_t>(size));
+			glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+		}
+		else
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		size_t offset = 0;
+		for (unsigned level = 0; level < m_levels[map]; ++level)
+		{
+			size_t level_size = TextureCache::LevelSize(m_format[map], std::max(m_width[map] >> level, 1u), std::max(m_height[map] >> level, 1u));
+			// with the buffer bound the pointer is an offset into it, otherwise client memory
+			const void* source = pixels ? reinterpret_cast<const void*>(offset) : data + offset;
+			SubImage(map, level, image.layer, 1, source, level_size);
+			offset += level_size;
+		}
+		if (!pixels)
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo);
+	}
+	else
+	{
+		std::string path = packed_caches[map] ? MaterialCachePath(map, image.layer) : MaterialSources(map, image.layer)[0];
+		if (image.cache)
+			std::cout << "Texture " << path << " is " << image.cache->header().width << "x" << image.cache->header().height
+				<< ", the array is " << m_width[map] << "x" << m_height[map] << std::endl;
+		else
+			std::cout << "Texture failed to load at path: " << path << std::endl;
+		// black like the incomplete texture a failed load used to leave
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		FillLayer(map, image.layer, black);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo);
+	}
+	delete image.cache;
+
+	--m_remaining;
+	if (--m_pending[map] == 0)
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BASE_LEVEL, 0);
+}
+void MaterialTable::SubImage(unsigned map, unsigned level, int layer, int depth, const void* pixels, size_t size) const
+{
+	GLsizei width = std::max(m_width[map] >> level, 1u), height = std::max(m_height[map] >> level, 1u);
+	if (TextureCache::Compressed(m_format[map]))
+		glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, layer, width, height, depth, m_format[map], static_cast<GLsizei>(size), pixels);
+	else
+		glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, layer, width, height, depth, GL_RGB, GL_UNSIGNED_BYTE, pixels);
+}
+void MaterialTable::FillLayer(unsigned map, int layer, const unsigned char color[3]) const
+{
+	std::vector<unsigned char> fill;
+	TextureCache::Fill(m_format[map], m_width[map], m_height[map], color, fill);
+	for (unsigned level = 0; level < m_levels[map]; ++level)
+		SubImage(map, level, layer, 1, &fill[0],
+			TextureCache::LevelSize(m_format[map], std::max(m_width[map] >> level, 1u), std::max(m_height[map] >> level, 1u)));
+}
+void MaterialTable::StopWorkers()
+{
+	// workers finish the image they are on and claim no more
+	m_next = material_images;
+	for (std::thread& worker : m_workers)
+		worker.join();
+	m_workers.clear();
+}
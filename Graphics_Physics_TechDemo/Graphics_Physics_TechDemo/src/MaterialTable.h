@@ -0,0 +1,85 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: MaterialTable.h
+Purpose: Every PBR texture set in one texture array per map, indexed by TextureType
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#pragma once
+
+#ifndef MATERIALTABLE_H
+#define MATERIALTABLE_H
+
+#include "Object.h"
+#include "TextureCache.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// one layer per TextureType, PLASTIC to GOLD
+#define MATERIAL_COUNT (GOLD + 1)
+// albedo, normal, and ao, roughness and metallic packed in one
+#define MATERIAL_MAPS 3
+// units 0-2 hold the IBL maps, the arrays go on the next three
+#define MATERIAL_TEXTURE_UNIT 3
+// cached images copied into the arrays per Update, 2.7 MB at 2048x2048 BC1, 5.3 MB BC5 or BC7, with mips
+#define MATERIAL_UPLOADS_PER_FRAME 4
+
+class MaterialTable {
+public:
+	MaterialTable();
+	~MaterialTable();
+
+	// sizes the arrays from the file headers, fills them with placeholders and starts worker threads
+	// that map each image's TextureCache, building it on the first run. An image that fails to load
+	// leaves its layer black, a missing orm file only its channel
+	void Load();
+	// copies images the workers finished into the arrays through a pixel buffer, in the order they
+	// finished. Once per frame on the GL thread
+	void Update();
+	void Delete();
+	// the three arrays on MATERIAL_TEXTURE_UNIT and up, once per frame
+	void Bind() const;
+
+	bool Loaded() const { return m_arrays[0] != 0; }
+private:
+	MaterialTable(const MaterialTable&);
+	MaterialTable& operator=(const MaterialTable&);
+
+	struct Decoded {
+		unsigned map;
+		int layer;
+		// null when the image failed to load
+		TextureCache* cache;
+	};
+
+	void DecodeLoop();
+	void Upload(const Decoded& image);
+	// one level of depth layers from layer on, pixels is an offset when a pixel buffer is bound
+	void SubImage(unsigned map, unsigned level, int layer, int depth, const void* pixels, size_t size) const;
+	// every level of layer in one color
+	void FillLayer(unsigned map, int layer, const unsigned char color[3]) const;
+	void StopWorkers();
+
+	unsigned m_arrays[MATERIAL_MAPS];
+	unsigned m_format[MATERIAL_MAPS];
+	unsigned m_width[MATERIAL_MAPS], m_height[MATERIAL_MAPS], m_levels[MATERIAL_MAPS];
+	// layers of each map not uploaded yet, the map shows its full chain when this reaches 0
+	unsigned m_pending[MATERIAL_MAPS];
+	unsigned m_remaining;
+	unsigned m_pbo;
+
+	std::vector<std::thread> m_workers;
+	std::atomic<unsigned> m_next;
+	std::mutex m_mutex;
+	std::vector<Decoded> m_ready;
+};
+
+#endif
@@ -0,0 +1,115 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: MeshCache.cpp
+Purpose: Versioned binary cache of a loaded OBJ, mapped and uploaded as is
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#include "MeshCache.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+#define MESH_CACHE_MAGIC "GPTM"
+
+static_assert(sizeof(MeshVertex) == 32, "MeshVertex is uploaded as a 32 byte stride");
+static_assert(sizeof(MeshCacheHeader) % 8 == 0, "vertices follow the header aligned");
+
+namespace
+{
+	size_t CacheSize(const MeshCacheHeader& header)
+	{
+		return sizeof(MeshCacheHeader) + static_cast<size_t>(header.vertex_count) * sizeof(MeshVertex)
+			+ static_cast<size_t>(header.index_count) * header.index_size;
+	}
+}
+
+std::string MeshCache::CachePath(const char* source)
+{
+	return std::string(source) + MESH_CACHE_EXTENSION;
+}
+
+bool MeshCache::Write(const char* source, const float bounds[6], const glm::vec3& middle_point,
+	const std::vector<MeshVertex>& vertices, const std::vector<unsigned>& indices)
+{
+	MeshCacheHeader header = {};
+	memcpy(header.magic, MESH_CACHE_MAGIC, sizeof(header.magic));
+	header.version = MESH_CACHE_VERSION;
+	if (!SourceStamp(source, header.source_size, header.source_mtime) || !HashSource(source, header.source_hash))
+		return false;
+	header.vertex_count = static_cast<unsigned>(vertices.size());
+	header.index_count = static_cast<unsigned>(indices.size());
+	header.index_size = vertices.size() <= 0x10000 ? 2 : 4;
+	memcpy(header.bounds, bounds, sizeof(header.bounds));
+	header.middle_point = middle_point;
+
+	std::string path = CachePath(source);
+	FILE* file = fopen(path.c_str(), "wb");
+	if (!file)
+		return false;
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+	if (written && !vertices.empty())
+		written = fwrite(&vertices[0], sizeof(MeshVertex), vertices.size(), file) == vertices.size();
+	if (written && !indices.empty())
+	{
+		if (header.index_size == 2)
+		{
+			std::vector<unsigned short> shorts(indices.begin(), indices.end());
+			written = fwrite(&shorts[0], sizeof(unsigned short), shorts.size(), file) == shorts.size();
+		}
+		else
+			written = fwrite(&indices[0], sizeof(unsigned), indices.size(), file) == indices.size();
+	}
+	written = fclose(file) == 0 && written;
+	// a partial file would fail the size check anyway, don't leave it around
+	if (!written)
+		remove(path.c_str());
+	return written;
+}
+
+bool MeshCache::Open(const char* source)
+{
+	Close();
+	unsigned long long size;
+	long long mtime;
+	std::string path = CachePath(source);
+	if (!SourceStamp(source, size, mtime) || !m_file.Open(path.c_str()))
+		return false;
+
+	bool valid = m_file.size() >= sizeof(MeshCacheHeader), touched = false;
+	if (valid)
+	{
+		const MeshCacheHeader& h = header();
+		valid = !memcmp(h.magic, MESH_CACHE_MAGIC, sizeof(h.magic)) && h.version == MESH_CACHE_VERSION
+			&& (h.index_size == 2 || h.index_size == 4) && m_file.size() == CacheSize(h) && h.source_size == size;
+		// a touched but unchanged OBJ (checkout, copy) still matches by content
+		unsigned long long hash;
+		touched = valid && h.source_mtime != mtime;
+		if (touched)
+			valid = HashSource(source, hash) && hash == h.source_hash;
+	}
+	if (!valid)
+	{
+		Close();
+		return false;
+	}
+	if (touched)
+	{
+		// take the new mtime so only the first load after the touch hashes the OBJ
+		size_t expected = m_file.size();
+		Close();
+		RestampCache(path.c_str(), offsetof(MeshCacheHeader, source_mtime), mtime);
+		if (!m_file.Open(path.c_str()) || m_file.size() != expected)
+		{
+			Close();
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,70 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: MeshCache.h
+Purpose: Versioned binary cache of a loaded OBJ, mapped and uploaded as is
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#pragma once
+
+#ifndef MESHCACHE_H
+#define MESHCACHE_H
+
+#include "FileUtil.h"
+#include "glm/glm.hpp"
+#include <string>
+#include <vector>
+
+// bump whenever MeshCacheHeader, MeshVertex or what loadOBJ computes changes
+#define MESH_CACHE_VERSION 1
+// written next to the OBJ, genie_lamp.obj -> genie_lamp.obj.mesh
+#define MESH_CACHE_EXTENSION ".mesh"
+
+// one interleaved vertex, the layout Describe uploads for O_OBJ
+struct MeshVertex {
+	glm::vec3 position;
+	glm::vec3 normal;
+	glm::vec2 uv;
+};
+
+// file layout: header, vertex_count MeshVertex, index_count indices of index_size bytes
+struct MeshCacheHeader {
+	char magic[4];
+	unsigned version;
+	// the OBJ the cache was built from, the hash is only checked when the mtime differs
+	unsigned long long source_size;
+	long long source_mtime;
+	unsigned long long source_hash;
+	unsigned vertex_count;
+	unsigned index_count;
+	unsigned index_size;	// 2 when every vertex fits in 16 bits, else 4
+	// xMin, xMax, yMin, yMax, zMin, zMax and middlePoint as loadOBJ left them
+	float bounds[6];
+	glm::vec3 middle_point;
+	unsigned reserved[4];
+};
+
+class MeshCache {
+public:
+	static std::string CachePath(const char* source);
+	// false and nothing written if the cache file can't be created
+	static bool Write(const char* source, const float bounds[6], const glm::vec3& middle_point,
+		const std::vector<MeshVertex>& vertices, const std::vector<unsigned>& indices);
+
+	// map the cache of source, false when it is missing, truncated, another version or stale
+	bool Open(const char* source);
+	void Close() { m_file.Close(); }
+
+	const MeshCacheHeader& header() const { return *reinterpret_cast<const MeshCacheHeader*>(m_file.data()); }
+	const MeshVertex* vertices() const { return reinterpret_cast<const MeshVertex*>(m_file.data() + sizeof(MeshCacheHeader)); }
+	const void* indices() const { return vertices() + header().vertex_count; }
+private:
+	MappedFile m_file;
+};
+
+#endif
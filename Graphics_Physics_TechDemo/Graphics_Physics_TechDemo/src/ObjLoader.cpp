@@ -0,0 +1,414 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: ObjLoader.cpp
+Purpose: Chunked parallel Wavefront OBJ parser
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#include "ObjLoader.h"
+#include "FileUtil.h"
+#include "ThreadPool.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace
+{
+	enum ObjLine {
+		OBJ_OTHER,
+		OBJ_POSITION,
+		OBJ_UV,
+		OBJ_FACE,
+	};
+
+	struct ObjChunk {
+		const char* begin;
+		const char* end;
+		// counted by the first pass
+		unsigned positions, uvs, triangles;
+		// elements of the chunks before this one
+		unsigned first_position, first_uv, first_triangle;
+		bool failed;
+	};
+
+	// every power of ten a float holds exactly
+	const float powers_of_ten[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+
+	inline bool IsSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	inline bool IsDigit(char c)
+	{
+		return c >= '0' && c <= '9';
+	}
+
+	inline const char* SkipSpace(const char* p, const char* end)
+	{
+		while (p < end && IsSpace(*p))
+			++p;
+		return p;
+	}
+
+	inline const char* LineEnd(const char* p, const char* end)
+	{
+		const void* newline = memchr(p, '\n', end - p);
+		return newline ? static_cast<const char*>(newline) : end;
+	}
+
+	// moves p past the keyword of the line
+	ObjLine Classify(const char*& p, const char* end)
+	{
+		p = SkipSpace(p, end);
+		if (end - p > 1 && p[0] == 'v' && IsSpace(p[1]))
+		{
+			p += 2;
+			return OBJ_POSITION;
+		}
+		if (end - p > 2 && p[0] == 'v' && p[1] == 't' && IsSpace(p[2]))
+		{
+			p += 3;
+			return OBJ_UV;
+		}
+		if (end - p > 1 && p[0] == 'f' && IsSpace(p[1]))
+		{
+			p += 2;
+			return OBJ_FACE;
+		}
+		return OBJ_OTHER;
+	}
+
+	// the digits go into an integer; when it fits a float's 24 bit significand and the power of ten is
+	// exact, one float multiply or divide rounds once to the nearest float. Longer numbers and larger
+	// exponents, rare in OBJ files, go through strtof
+	const char* ParseFloat(const char* p, const char* end, float& value)
+	{
+		p = SkipSpace(p, end);
+		const char* start = p;
+		bool negative = false;
+		if (p < end && (*p == '-' || *p == '+'))
+			negative = *p++ == '-';
+
+		uint64_t mantissa = 0;
+		int exponent = 0;
+		bool any = false;
+		for (; p < end && IsDigit(*p); ++p, any = true)
+		{
+			if (mantissa < (1ull << 40))
+				mantissa = mantissa * 10 + (*p - '0');
+			else
+				++exponent;
+		}
+		if (p < end && *p == '.')
+		{
+			for (++p; p < end && IsDigit(*p); ++p, any = true)
+			{
+				if (mantissa < (1ull << 40))
+				{
+					mantissa = mantissa * 10 + (*p - '0');
+					--exponent;
+				}
+			}
+		}
+		if (!any)
+			return nullptr;
+
+		if (p < end && (*p == 'e' || *p == 'E'))
+		{
+			const char* q = p + 1;
+			bool negative_exponent = false;
+			if (q < end && (*q == '-' || *q == '+'))
+				negative_exponent = *q++ == '-';
+			if (q < end && IsDigit(*q))
+			{
+				int e = 0;
+				for (; q < end && IsDigit(*q); ++q)
+					if (e < 10000)
+						e = e * 10 + (*q - '0');
+				exponent += negative_exponent ? -e : e;
+				p = q;
+			}
+		}
+
+		if (mantissa < (1u << 24) && exponent >= -10 && exponent <= 10)
+		{
+			float result = static_cast<float>(mantissa);
+			if (exponent < 0)
+				result /= powers_of_ten[-exponent];
+			else
+				result *= powers_of_ten[exponent];
+			value = negative ? -result : result;
+			return p;
+		}
+		// the mapped file isn't null terminated, strtof gets a copy of the number
+		char buffer[64];
+		std::string copy;
+		const char* text = buffer;
+		size_t length = static_cast<size_t>(p - start);
+		if (length < sizeof(buffer))
+		{
+			memcpy(buffer, start, length);
+			buffer[length] = 0;
+		}
+		else
+		{
+			copy.assign(start, p);
+			text = copy.c_str();
+		}
+		value = strtof(text, nullptr);
+		return p;
+	}
+
+	const char* ParseInt(const char* p, const char* end, long long& value)
+	{
+		bool negative = false;
+		if (p < end && (*p == '-' || *p == '+'))
+			negative = *p++ == '-';
+		if (p >= end || !IsDigit(*p))
+			return nullptr;
+		long long result = 0;
+		for (; p < end && IsDigit(*p); ++p)
+			if (result < (1ll << 40))
+				result = result * 10 + (*p - '0');
+		value = negative ? -result : result;
+		return p;
+	}
+
+	// v, v/vt, v//vn or v/vt/vn, has_vt is false for the first two forms
+	const char* ParseCorner(const char* p, const char* end, long long& v, long long& vt, bool& has_vt)
+	{
+		has_vt = false;
+		p = ParseInt(p, end, v);
+		if (!p || p >= end || *p != '/')
+			return p;
+		++p;
+		if (p < end && *p != '/')
+		{
+			has_vt = true;
+			p = ParseInt(p, end, vt);
+			if (!p || p >= end || *p != '/')
+				return p;
+		}
+		long long vn;
+		return ParseInt(p + 1, end, vn);
+	}
+
+	// OBJ indices are 1 based, negative ones count back from the elements read so far
+	bool Resolve(long long index, unsigned read, unsigned total, unsigned& resolved)
+	{
+		long long i = index > 0 ? index - 1 : static_cast<long long>(read) + index;
+		if (index == 0 || i < 0 || i >= total)
+			return false;
+		resolved = static_cast<unsigned>(i);
+		return true;
+	}
+
+	unsigned CountCorners(const char* p, const char* end)
+	{
+		unsigned corners = 0;
+		for (p = SkipSpace(p, end); p < end && *p != '#'; p = SkipSpace(p, end))
+		{
+			++corners;
+			while (p < end && !IsSpace(*p))
+				++p;
+		}
+		return corners;
+	}
+
+	void CountChunk(ObjChunk& chunk)
+	{
+		for (const char* line = chunk.begin; line < chunk.end;)
+		{
+			const char* end = LineEnd(line, chunk.end);
+			const char* p = line;
+			switch (Classify(p, end))
+			{
+			case OBJ_POSITION:
+				++chunk.positions;
+				break;
+			case OBJ_UV:
+				++chunk.uvs;
+				break;
+			case OBJ_FACE:
+			{
+				unsigned corners = CountCorners(p, end);
+				if (corners < 3)
+				{
+					chunk.failed = true;
+					return;
+				}
+				chunk.triangles += corners - 2;
+				break;
+			}
+			default:
+				break;
+			}
+			line = end + 1;
+		}
+	}
+
+	void ParseChunk(ObjChunk& chunk, ObjMesh& mesh)
+	{
+		unsigned total_positions = static_cast<unsigned>(mesh.positions.size());
+		unsigned total_uvs = static_cast<unsigned>(mesh.uvs.size());
+		unsigned position = chunk.first_position;
+		unsigned uv = chunk.first_uv;
+		unsigned index = chunk.first_triangle * 3;
+		std::vector<unsigned> v_corners, vt_corners;
+
+		for (const char* line = chunk.begin; line < chunk.end;)
+		{
+			const char* end = LineEnd(line, chunk.end);
+			const char* p = line;
+			switch (Classify(p, end))
+			{
+			case OBJ_POSITION:
+			{
+				// a trailing w or vertex color is ignored
+				glm::vec3& vertex = mesh.positions[position++];
+				if (!(p = ParseFloat(p, end, vertex.x)) || !(p = ParseFloat(p, end, vertex.y)) || !ParseFloat(p, end, vertex.z))
+				{
+					chunk.failed = true;
+					return;
+				}
+				break;
+			}
+			case OBJ_UV:
+			{
+				glm::vec2& coord = mesh.uvs[uv++];
+				if (!(p = ParseFloat(p, end, coord.x)) || !ParseFloat(p, end, coord.y))
+				{
+					chunk.failed = true;
+					return;
+				}
+				break;
+			}
+			case OBJ_FACE:
+			{
+				v_corners.clear();
+				vt_corners.clear();
+				for (p = SkipSpace(p, end); p < end && *p != '#'; p = SkipSpace(p, end))
+				{
+					long long v, vt;
+					bool has_vt;
+					unsigned vi, ti = OBJ_NO_UV;
+					p = ParseCorner(p, end, v, vt, has_vt);
+					if (!p || (p < end && !IsSpace(*p)) || !Resolve(v, position, total_positions, vi)
+						|| (has_vt && !Resolve(vt, uv, total_uvs, ti)))
+					{
+						chunk.failed = true;
+						return;
+					}
+					v_corners.push_back(vi);
+					vt_corners.push_back(ti);
+				}
+
+				unsigned n = static_cast<unsigned>(v_corners.size());
+				unsigned* positions = &mesh.position_indices[0];
+				unsigned* uvs = &mesh.uv_indices[0];
+				// quads keep the 0-1-3 / 1-2-3 split of the fscanf loader
+				if (n == 4)
+				{
+					const unsigned order[6] = { 0, 1, 3, 1, 2, 3 };
+					for (unsigned corner : order)
+					{
+						positions[index] = v_corners[corner];
+						uvs[index++] = vt_corners[corner];
+					}
+				}
+				else
+				{
+					for (unsigned i = 1; i + 1 < n; ++i)
+					{
+						const unsigned order[3] = { 0, i, i + 1 };
+						for (unsigned corner : order)
+						{
+							positions[index] = v_corners[corner];
+							uvs[index++] = vt_corners[corner];
+						}
+					}
+				}
+				break;
+			}
+			default:
+				break;
+			}
+			line = end + 1;
+		}
+	}
+}
+
+bool LoadObj(const char* path, ObjMesh& mesh)
+{
+	MappedFile file;
+	if (!file.Open(path))
+	{
+		printf("Impossible to open the file !\n");
+		return false;
+	}
+
+	// chunks end after the newline that follows every OBJ_CHUNK_BYTES
+	std::vector<ObjChunk> chunks;
+	const char* data = file.data();
+	const char* end = data + file.size();
+	for (const char* begin = data; begin < end;)
+	{
+		const char* split = end - begin > OBJ_CHUNK_BYTES ? LineEnd(begin + OBJ_CHUNK_BYTES, end) : end;
+		if (split < end)
+			++split;
+		ObjChunk chunk = {};
+		chunk.begin = begin;
+		chunk.end = split;
+		chunks.push_back(chunk);
+		begin = split;
+	}
+
+	ThreadPool& pool = ThreadPool::Instance();
+	unsigned count = static_cast<unsigned>(chunks.size());
+	pool.ParallelFor(count, 1, [&chunks](unsigned begin, unsigned end) {
+		for (unsigned i = begin; i < end; ++i)
+			CountChunk(chunks[i]);
+	});
+
+	unsigned positions = 0, uvs = 0, triangles = 0;
+	bool failed = false;
+	for (auto& chunk : chunks)
+	{
+		chunk.first_position = positions;
+		chunk.first_uv = uvs;
+		chunk.first_triangle = triangles;
+		positions += chunk.positions;
+		uvs += chunk.uvs;
+		triangles += chunk.triangles;
+		failed |= chunk.failed;
+	}
+
+	if (!failed)
+	{
+		mesh.positions.resize(positions);
+		mesh.uvs.resize(uvs);
+		mesh.position_indices.resize(triangles * 3);
+		mesh.uv_indices.resize(triangles * 3);
+		pool.ParallelFor(count, 1, [&chunks, &mesh](unsigned begin, unsigned end) {
+			for (unsigned i = begin; i < end; ++i)
+				ParseChunk(chunks[i], mesh);
+		});
+		for (auto& chunk : chunks)
+			failed |= chunk.failed;
+	}
+	if (failed)
+	{
+		printf("File can't be read by our simple parser : ( Try exporting with other options\n");
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,40 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: ObjLoader.h
+Purpose: Chunked parallel Wavefront OBJ parser
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#pragma once
+
+#ifndef OBJLOADER_H
+#define OBJLOADER_H
+
+#include "glm/glm.hpp"
+#include <vector>
+
+// files are split into chunks of about this many bytes, one parallel job each
+#define OBJ_CHUNK_BYTES (1 << 20)
+// uv index of a face corner that has no vt
+#define OBJ_NO_UV 0xffffffffu
+
+// triangulated faces with one index list per attribute, vn is skipped since normals are recomputed
+struct ObjMesh {
+	std::vector<glm::vec3> positions;
+	std::vector<glm::vec2> uvs;
+	std::vector<unsigned> position_indices;
+	// parallel to position_indices, OBJ_NO_UV for corners without a vt
+	std::vector<unsigned> uv_indices;
+};
+
+// v, vt and f lines with v, v/vt, v//vn or v/vt/vn corners, negative indices count back from the
+// current line. Quads split along their 1-3 diagonal, larger polygons are fanned around their first corner.
+// False if the file can't be opened or a face is malformed or out of range.
+bool LoadObj(const char* path, ObjMesh& mesh);
+
+#endif
@@ -16,17 +16,72 @@ End Header --------------------------------------------------------*/
 #define STB_IMAGE_IMPLEMENTATION
 #define WIDTH 1600
 #define HEIGHT 1000
+// faces or vertices per job of the normal pass
+#define NORMALS_MIN_BATCH 2048
+// fraction of the mesh's extent within which positions share a normal
+#define NORMAL_WELD_EPSILON 1e-5f
+#define ENVIRONMENT_HDR "models\\newport_loft.hdr"
+// the LUT only depends on the BRDF, one cache for every environment
+#define BRDF_LUT_CACHE "models\\brdf_lut" IBL_CACHE_EXTENSION
 #include "glad/glad.h"
 #include "glm/gtc/matrix_transform.hpp"
 #include "GLFW/glfw3.h"
 #include "glm/gtc/type_ptr.hpp"
+#include "glm/packing.hpp"
 #include "..\include\stb_image.h"
 #include "Object.h"
 #include "Shader.h"
-#include "Camera.h"
-
+#include "ThreadPool.h"
+#include "ObjLoader.h"
+#include "MeshCache.h"
+#include "IblCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <unordered_map>
+
+bool Object::headless = false;
+bool Object::packed_vertices = true;
+
+namespace
+{
+	// snorm16 xyz (w unused), octahedral snorm16 normal, half uv
+	struct PackedVertex {
+		glm::uint position_xy;
+		glm::uint position_z;
+		glm::uint normal;
+		glm::uint uv;
+	};
+	static_assert(sizeof(PackedVertex) == 16, "PackedVertex is uploaded as a 16 byte stride");
+
+	// octahedral map of the direction, the decode lives in pbr_texture.vs
+	glm::vec2 OctEncode(glm::vec3 n)
+	{
+		float length = glm::abs(n.x) + glm::abs(n.y) + glm::abs(n.z);
+		if (length <= 0.f)
+			return glm::vec2(0.f);
+		n /= length;
+		glm::vec2 e(n.x, n.y);
+		if (n.z < 0.f)
+			e = glm::vec2((1.f - glm::abs(n.y)) * (n.x >= 0.f ? 1.f : -1.f), (1.f - glm::abs(n.x)) * (n.y >= 0.f ? 1.f : -1.f));
+		return e;
+	}
+
+	// weld grid cell, 21 bits per axis offset to unsigned. The cells span the mesh's extent over
+	// NORMAL_WELD_EPSILON on either side of the origin, well inside the range
+	unsigned long long WeldCellKey(int x, int y, int z)
+	{
+		const int offset = 1 << 20;
+		return (static_cast<unsigned long long>(x + offset) << 42)
+			| (static_cast<unsigned long long>(y + offset) << 21)
+			| static_cast<unsigned long long>(z + offset);
+	}
+}
 
 Object::Object(ObjectShape shape, glm::vec3 pos, glm::vec3 scale_, int dim)
 	: position(pos), scale(scale_), color(glm::vec3(1.0f, 1.0f, 1.0f)), rotation(0.f),
@@ -47,11 +102,21 @@ Object::Object(ObjectShape shape, glm::vec3 pos, glm::vec3 scale_, int dim)
 }
 Object::~Object()
 {
+	delete m_mesh_cache;
+	if (!m_vao)
+		return;
 	glDeleteVertexArrays(1, &m_vao);
 	glDeleteBuffers(1, &m_vbo);
 	glDeleteBuffers(1, &normalBuffer);
 	glDeleteBuffers(1, &textureBuffer);
 	glDeleteBuffers(1, &m_ebo);
+	for (unsigned i = 0; i < STREAM_FRAMES; ++i)
+		if (m_stream_fence[i])
+			glDeleteSync(static_cast<GLsync>(m_stream_fence[i]));
+	if (m_stream_buffer)
+		glDeleteBuffers(1, &m_stream_buffer);
+	if (m_instance_buffer)
+		glDeleteBuffers(1, &m_instance_buffer);
 }
 void Object::CreateObject(const char* path, glm::vec3 initial_position, glm::vec3 initial_scale)
 {
@@ -63,6 +128,8 @@ void Object::CreateObject(const char* path, glm::vec3 initial_position, glm::vec
 }
 void Object::GenerateBuffers()
 {
+	if (headless)
+		return;
 	glGenVertexArrays(1, &m_vao);
 
 	glGenBuffers(1, &m_vbo);
@@ -72,6 +139,17 @@ void Object::GenerateBuffers()
 }
 void Object::Describe()
 {
+	if (!m_vao)
+		return;
+	if (m_shape == O_OBJ)
+	{
+		DescribeMesh();
+		return;
+	}
+	if (packed_vertices && !m_dynamic && DescribePacked())
+		return;
+	m_packed = false;
+
 	glBindVertexArray(m_vao);
 	glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
  	glBufferData(GL_ARRAY_BUFFER, obj_vertices.size() * sizeof(glm::vec3), &obj_vertices[0], GL_STATIC_DRAW);
@@ -111,172 +189,430 @@ void Object::Describe()
 	glEnableVertexAttribArray(2);
 	glBindBuffer(GL_ARRAY_BUFFER, normalBuffer);
 	glVertexAttribPointer(2, two_components_in_vertex_normal, float_element_type, not_fixedpoint, vertex_size_stride, normal_offset_in_vertex);
+	glDisableVertexAttribArray(3);
 
+	UploadIndices();
+}
+bool Object::DescribePacked()
+{
+	unsigned count = static_cast<unsigned>(obj_vertices.size());
+	if (!count || textureUV.size() != count || vertexNormals.size() != count)
+		return false;
+	// snorm16 covers the unit sphere and the unit plane, anything else keeps floats
+	for (const glm::vec3& vertex : obj_vertices)
+		if (glm::abs(vertex.x) > 1.f || glm::abs(vertex.y) > 1.f || glm::abs(vertex.z) > 1.f)
+			return false;
+	// the octahedral encoding drops the length, which the rasterizer would interpolate with
+	for (const glm::vec3& normal : vertexNormals)
+		if (glm::abs(glm::dot(normal, normal) - 1.f) > 1e-3f)
+			return false;
+
+	std::vector<PackedVertex> vertices(count);
+	for (unsigned i = 0; i < count; ++i)
+	{
+		vertices[i].position_xy = glm::packSnorm2x16(glm::vec2(obj_vertices[i].x, obj_vertices[i].y));
+		vertices[i].position_z = glm::packSnorm2x16(glm::vec2(obj_vertices[i].z, 1.f));
+		vertices[i].normal = glm::packSnorm2x16(OctEncode(vertexNormals[i]));
+		vertices[i].uv = glm::packHalf2x16(textureUV[i]);
+	}
+
+	const GLsizei stride = sizeof(PackedVertex);
+	glBindVertexArray(m_vao);
+	glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+	glBufferData(GL_ARRAY_BUFFER, count * sizeof(PackedVertex), &vertices[0], GL_STATIC_DRAW);
+
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 4, GL_SHORT, GL_TRUE, stride, reinterpret_cast<void*>(offsetof(PackedVertex, position_xy)));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 2, GL_HALF_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(offsetof(PackedVertex, uv)));
+	glDisableVertexAttribArray(2);
+	glEnableVertexAttribArray(3);
+	glVertexAttribPointer(3, 2, GL_SHORT, GL_TRUE, stride, reinterpret_cast<void*>(offsetof(PackedVertex, normal)));
+
+	UploadIndices();
+	m_packed = true;
+	return true;
+}
+void Object::UploadIndices()
+{
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, obj_indices.size() * sizeof(unsigned int), &obj_indices[0], GL_STATIC_DRAW); // indices for texture
+	if (obj_vertices.size() <= 0x10000)
+	{
+		std::vector<unsigned short> indices(obj_indices.begin(), obj_indices.end());
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned short), indices.empty() ? nullptr : &indices[0], GL_STATIC_DRAW);
+		m_index_type = GL_UNSIGNED_SHORT;
+	}
+	else
+	{
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, obj_indices.size() * sizeof(unsigned int), &obj_indices[0], GL_STATIC_DRAW); // indices for texture
+		m_index_type = GL_UNSIGNED_INT;
+	}
 	m_elementSize = (unsigned)obj_indices.size();
 }
-bool Object::loadOBJ(const char* path, glm::vec3& middlePoint)
+void Object::MakeDynamic()
 {
-	float max_x = 0, min_x = 0, max_y = 0, min_y = 0, max_z = 0, min_z = 0, abs_max = 0;
-	//isUsingTexture = isUseTexture;
-	FILE* file = fopen(path, "r");
-	if (file == NULL)
+	// the streamed positions and normals are floats
+	m_dynamic = true;
+	if (m_packed)
+		Describe();
+	if (!m_vao || m_stream_buffer || !(GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage))
+		return;
+	m_stream_normal_offset = obj_vertices.size() * sizeof(glm::vec3);
+	m_stream_slot = m_stream_normal_offset + vertexNormals.size() * sizeof(glm::vec3);
+
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glGenBuffers(1, &m_stream_buffer);
+	glBindBuffer(GL_ARRAY_BUFFER, m_stream_buffer);
+	glBufferStorage(GL_ARRAY_BUFFER, m_stream_slot * STREAM_FRAMES, nullptr, flags);
+	m_stream_ptr = static_cast<unsigned char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, m_stream_slot * STREAM_FRAMES, flags));
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	if (!m_stream_ptr)
 	{
-		printf("Impossible to open the file !\n");
-		return false;
+		glDeleteBuffers(1, &m_stream_buffer);
+		m_stream_buffer = 0;
 	}
-	while (1)
+}
+void Object::Stream()
+{
+	if (!m_vao)
+		return;
+	// without buffer storage, overwrite the existing storage instead of reallocating it
+	if (!m_stream_ptr)
 	{
-		char lineHeader[128];
-		int res = fscanf(file, "%s", lineHeader);
-		if (res == EOF)
-		{
-			faceNormals.clear();
-			for (unsigned i = 0; i < obj_indices.size(); i += 3)
-			{
-				glm::vec3 vec1 = obj_vertices[obj_indices[i + unsigned(2)]] - obj_vertices[obj_indices[i]];
-				glm::vec3 vec2 = obj_vertices[obj_indices[i + unsigned(1)]] - obj_vertices[obj_indices[i]];
-				glm::vec3 faceNormal = glm::normalize(glm::cross(vec2, vec1));
-
-				for (unsigned j = 0; j < 3; ++j)
-				{
-					bool exist = false;
-					auto it = faceNormals.equal_range(obj_indices[i + j]);
-					for (auto iterator = it.first; iterator != it.second; ++iterator)
-					{
-						if (iterator->second == faceNormal)
-						{
-							exist = true;
-							break;
-						}
-					}
-					if (!exist)
-						faceNormals.insert(std::make_pair(obj_indices[i + j], faceNormal));
-				}
-			}
-			vertexNormals.clear();
-			vertexNormals.resize(obj_vertices.size());
-			for (auto face_it : faceNormals)
-			{
-				vertexNormals[face_it.first] += face_it.second;
-			}
-			for (auto& face_it : vertexNormals)
-			{
-				face_it = glm::normalize(face_it);
-			}
+		glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, obj_vertices.size() * sizeof(glm::vec3), &obj_vertices[0]);
+		glBindBuffer(GL_ARRAY_BUFFER, normalBuffer);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, vertexNormals.size() * sizeof(glm::vec3), &vertexNormals[0]);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		return;
+	}
 
-			// Save min & max
-			xMax = max_x;
-			xMin = min_x;
-			yMax = max_y;
-			yMin = min_y;
-			/* Set position and scale to default [-1, 1] */
-			if (abs_max < glm::abs(max_x - min_x))
-				abs_max = glm::abs(max_x - min_x);
-			if (abs_max < glm::abs(max_y - min_y))
-				abs_max = glm::abs(max_y - min_y);
-			if (abs_max < glm::abs(max_z - min_z))
-				abs_max = glm::abs(max_z - min_z);
-
-			middlePoint = glm::vec3((max_x + min_x) / (2 * abs_max),
-				(max_y + min_y) / (2 * abs_max),
-				(max_z + min_z) / (2 * abs_max));
-
-			xMax /= (0.5f * abs_max);
-			xMin /= (0.5f * abs_max);
-			yMax /= (0.5f * abs_max);
-			yMin /= (0.5f * abs_max);
-			zMax /= (0.5f * abs_max);
-			zMin /= (0.5f * abs_max);
-			xMax -= (2.f * middlePoint.x);
-			xMin -= (2.f * middlePoint.x);
-			yMax -= (2.f * middlePoint.y);
-			yMin -= (2.f * middlePoint.y);
-			zMax -= (2.f * middlePoint.z);
-			zMin -= (2.f * middlePoint.z);
-			for (unsigned i = 0; i < test_indices.size(); i += 3)
-			{
-				textureUV_fromIndices.push_back(textureUV[test_indices[i]]);
-			}
-			break;
+	m_stream_frame = (m_stream_frame + 1) % STREAM_FRAMES;
+	// the slot was last drawn STREAM_FRAMES frames ago, usually long done
+	GLsync fence = static_cast<GLsync>(m_stream_fence[m_stream_frame]);
+	if (fence)
+	{
+		GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+		while (status == GL_TIMEOUT_EXPIRED)
+			status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+		glDeleteSync(fence);
+		m_stream_fence[m_stream_frame] = nullptr;
+	}
+
+	size_t offset = m_stream_frame * m_stream_slot;
+	memcpy(m_stream_ptr + offset, &obj_vertices[0], m_stream_normal_offset);
+	memcpy(m_stream_ptr + offset + m_stream_normal_offset, &vertexNormals[0], m_stream_slot - m_stream_normal_offset);
+
+	glBindVertexArray(m_vao);
+	glBindBuffer(GL_ARRAY_BUFFER, m_stream_buffer);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, reinterpret_cast<void*>(offset));
+	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 0, reinterpret_cast<void*>(offset + m_stream_normal_offset));
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+void Object::BuildNormalAdjacency()
+{
+	m_faces.clear();
+	if (m_shape == O_PLANE)
+	{
+		// makePlain builds a strip, every other triangle of it is wound the other way
+		for (unsigned k = 0; k + 2 < obj_indices.size(); ++k)
+		{
+			unsigned a = obj_indices[k], b = obj_indices[k + 1], c = obj_indices[k + 2];
+			if (a == b || b == c || a == c)
+				continue;
+			if (k & 1)
+				std::swap(a, b);
+			m_faces.push_back(a);
+			m_faces.push_back(b);
+			m_faces.push_back(c);
 		}
-		if (strcmp(lineHeader, "v") == 0)
+	}
+	else
+	{
+		// makeSphere winds its triangles inward, the same way CollisionResponseSoft reads them
+		for (unsigned k = 0; k + 2 < obj_indices.size(); k += 3)
 		{
-			glm::vec3 vertex;
-			fscanf(file, "%f %f %f\n", &vertex.x, &vertex.y, &vertex.z);
-
-			/* Find the min & max data which is in obj */
-			if (max_x > vertex.x)
-				max_x = vertex.x;
-			if (max_y > vertex.y)
-				max_y = vertex.y;
-			if (max_z > vertex.z)
-				max_z = vertex.z;
-
-			if (min_x < vertex.x)
-				min_x = vertex.x;
-			if (min_y < vertex.y)
-				min_y = vertex.y;
-			if (min_z < vertex.z)
-				min_z = vertex.z;
-
-			obj_vertices.push_back(vertex);
+			m_faces.push_back(obj_indices[k]);
+			m_faces.push_back(obj_indices[k + (m_shape == O_SPHERE ? 2 : 1)]);
+			m_faces.push_back(obj_indices[k + (m_shape == O_SPHERE ? 1 : 2)]);
 		}
+	}
 
-		if (strcmp(lineHeader, "f") == 0)
+	// makeSphere's seam and pole copies differ by rounding, so positions weld within a grid cell of
+	// NORMAL_WELD_EPSILON of the mesh's extent. The neighbouring cells are searched too, a pair
+	// straddling a cell border still welds
+	unsigned count = static_cast<unsigned>(obj_vertices.size());
+	float extent = 0.f;
+	for (const glm::vec3& p : obj_vertices)
+		extent = std::max(extent, std::max(std::abs(p.x), std::max(std::abs(p.y), std::abs(p.z))));
+	const float cell = std::max(extent * NORMAL_WELD_EPSILON, std::numeric_limits<float>::min());
+	m_normal_weld.resize(count);
+	std::unordered_map<unsigned long long, unsigned> first;
+	first.reserve(count);
+	for (unsigned v = 0; v < count; ++v)
+	{
+		const glm::vec3& p = obj_vertices[v];
+		const int x = static_cast<int>(std::floor(p.x / cell)), y = static_cast<int>(std::floor(p.y / cell)), z = static_cast<int>(std::floor(p.z / cell));
+		m_normal_weld[v] = v;
+		for (int i = 0; i < 27 && m_normal_weld[v] == v; ++i)
 		{
-			unsigned vertexIndex[4];
-			unsigned trash[4];
-			int matches = fscanf(file, "%d/%d %d/%d %d/%d %d/%d\n", &vertexIndex[0], &trash[0], &vertexIndex[1], &trash[1], &vertexIndex[2], &trash[2], &vertexIndex[3], &trash[3]);
-			if (matches == 8)
-			{
-				obj_indices.push_back(vertexIndex[0] - 1);
-				obj_indices.push_back(vertexIndex[1] - 1);
-				obj_indices.push_back(vertexIndex[3] - 1);
-
-				obj_indices.push_back(vertexIndex[1] - 1);
-				obj_indices.push_back(vertexIndex[2] - 1);
-				obj_indices.push_back(vertexIndex[3] - 1);
+			auto found = first.find(WeldCellKey(x + i % 3 - 1, y + i / 3 % 3 - 1, z + i / 9 - 1));
+			if (found != first.end() && glm::all(glm::lessThanEqual(glm::abs(obj_vertices[found->second] - p), glm::vec3(cell))))
+				m_normal_weld[v] = found->second;
+		}
+		if (m_normal_weld[v] == v)
+			first.insert(std::make_pair(WeldCellKey(x, y, z), v));
+	}
 
-				test_indices.push_back(trash[0] - 1);
-				test_indices.push_back(trash[1] - 1);
-				test_indices.push_back(trash[3] - 1);
+	m_vertex_face_start.assign(count + 1, 0);
+	for (unsigned corner : m_faces)
+		++m_vertex_face_start[m_normal_weld[corner] + 1];
+	for (unsigned v = 0; v < count; ++v)
+		m_vertex_face_start[v + 1] += m_vertex_face_start[v];
+
+	std::vector<unsigned> cursor(m_vertex_face_start.begin(), m_vertex_face_start.end() - 1);
+	m_vertex_faces.resize(m_faces.size());
+	for (unsigned i = 0; i < m_faces.size(); ++i)
+		m_vertex_faces[cursor[m_normal_weld[m_faces[i]]]++] = i / 3;
+	m_face_normals.resize(m_faces.size() / 3);
+}
+void Object::ComputeNormals()
+{
+	// a cache hit has neither the geometry nor the faces until something recomputes its normals
+	LoadCachedGeometry();
+	if (m_face_normals.empty())
+		BuildNormalAdjacency();
+	if (m_face_normals.empty())
+		return;
+	ThreadPool& pool = ThreadPool::Instance();
 
-				test_indices.push_back(trash[1] - 1);
-				test_indices.push_back(trash[2] - 1);
-				test_indices.push_back(trash[3] - 1);
-			}
-			else if (matches == 6)
-			{
-				obj_indices.push_back(vertexIndex[0] - 1);
-				obj_indices.push_back(vertexIndex[1] - 1);
-				obj_indices.push_back(vertexIndex[2] - 1);
+	// the cross product is twice the triangle's area, bigger faces weigh more
+	pool.ParallelFor(static_cast<unsigned>(m_face_normals.size()), NORMALS_MIN_BATCH, [this](unsigned begin, unsigned end) {
+		for (unsigned f = begin; f < end; ++f)
+		{
+			const glm::vec3& p0 = obj_vertices[m_faces[3 * f]];
+			m_face_normals[f] = glm::cross(obj_vertices[m_faces[3 * f + 1]] - p0, obj_vertices[m_faces[3 * f + 2]] - p0);
+		}
+	});
 
-				test_indices.push_back(trash[0] - 1);
-				test_indices.push_back(trash[1] - 1);
-				test_indices.push_back(trash[2] - 1);
-			}
-			else
-			{
-				printf("File can't be read by our simple parser : ( Try exporting with other options\n");
-				return false;
-			}
+	pool.ParallelFor(static_cast<unsigned>(obj_vertices.size()), NORMALS_MIN_BATCH, [this](unsigned begin, unsigned end) {
+		for (unsigned v = begin; v < end; ++v)
+		{
+			unsigned weld = m_normal_weld[v];
+			glm::vec3 sum(0.f);
+			for (unsigned i = m_vertex_face_start[weld]; i < m_vertex_face_start[weld + 1]; ++i)
+				sum += m_face_normals[m_vertex_faces[i]];
+			float length = glm::length(sum);
+			// a vertex with only degenerate faces keeps the normal it had
+			if (length > 0.f)
+				vertexNormals[v] = sum / length;
 		}
-		if (strcmp(lineHeader, "vt") == 0)
+	});
+}
+void Object::FenceStream()
+{
+	void*& fence = m_stream_fence[m_stream_frame];
+	if (fence)
+		glDeleteSync(static_cast<GLsync>(fence));
+	fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+bool Object::loadOBJ(const char* path, glm::vec3& middlePoint)
+{
+	float max_x = 0, min_x = 0, max_y = 0, min_y = 0, max_z = 0, min_z = 0, abs_max = 0;
+	//isUsingTexture = isUseTexture;
+	if (LoadMeshCache(path, middlePoint))
+		return true;
+
+	ObjMesh mesh;
+	if (!LoadObj(path, mesh))
+		return false;
+	obj_vertices.swap(mesh.positions);
+	textureUV.swap(mesh.uvs);
+	obj_indices.swap(mesh.position_indices);
+	test_indices.swap(mesh.uv_indices);
+
+	for (const glm::vec3& vertex : obj_vertices)
+	{
+		/* Find the min & max data which is in obj */
+		if (max_x > vertex.x)
+			max_x = vertex.x;
+		if (max_y > vertex.y)
+			max_y = vertex.y;
+		if (max_z > vertex.z)
+			max_z = vertex.z;
+
+		if (min_x < vertex.x)
+			min_x = vertex.x;
+		if (min_y < vertex.y)
+			min_y = vertex.y;
+		if (min_z < vertex.z)
+			min_z = vertex.z;
+	}
+
+	vertexNormals.assign(obj_vertices.size(), glm::vec3(0.f));
+	ComputeNormals();
+
+	// Save min & max
+	xMax = max_x;
+	xMin = min_x;
+	yMax = max_y;
+	yMin = min_y;
+	/* Set position and scale to default [-1, 1] */
+	if (abs_max < glm::abs(max_x - min_x))
+		abs_max = glm::abs(max_x - min_x);
+	if (abs_max < glm::abs(max_y - min_y))
+		abs_max = glm::abs(max_y - min_y);
+	if (abs_max < glm::abs(max_z - min_z))
+		abs_max = glm::abs(max_z - min_z);
+
+	middlePoint = glm::vec3((max_x + min_x) / (2 * abs_max),
+		(max_y + min_y) / (2 * abs_max),
+		(max_z + min_z) / (2 * abs_max));
+
+	xMax /= (0.5f * abs_max);
+	xMin /= (0.5f * abs_max);
+	yMax /= (0.5f * abs_max);
+	yMin /= (0.5f * abs_max);
+	zMax /= (0.5f * abs_max);
+	zMin /= (0.5f * abs_max);
+	xMax -= (2.f * middlePoint.x);
+	xMin -= (2.f * middlePoint.x);
+	yMax -= (2.f * middlePoint.y);
+	yMin -= (2.f * middlePoint.y);
+	zMax -= (2.f * middlePoint.z);
+	zMin -= (2.f * middlePoint.z);
+	// corners without a vt read (0, 0)
+	textureUV_fromIndices.reserve(test_indices.size() / 3);
+	for (unsigned i = 0; i < test_indices.size(); i += 3)
+	{
+		textureUV_fromIndices.push_back(test_indices[i] < textureUV.size() ? textureUV[test_indices[i]] : glm::vec2(0.f));
+	}
+	WriteMeshCache(path, middlePoint);
+	return true;
+}
+namespace
+{
+	// vertex i takes textureUV_fromIndices[i], the attribute Describe binds for O_OBJ
+	void Interleave(const Object& object, std::vector<MeshVertex>& vertices)
+	{
+		vertices.resize(object.obj_vertices.size());
+		for (unsigned i = 0; i < vertices.size(); ++i)
 		{
-			glm::vec2 uv;
-			int matches = fscanf(file, "%f %f\n", &uv.x, &uv.y);
-			if (matches != 2)
-			{
-				printf("File can't be read by our simple parser : ( Try exporting with other options\n");
-				return false;
-			}
-			textureUV.push_back(uv);
+			vertices[i].position = object.obj_vertices[i];
+			vertices[i].normal = i < object.vertexNormals.size() ? object.vertexNormals[i] : glm::vec3(0.f);
+			vertices[i].uv = i < object.textureUV_fromIndices.size() ? object.textureUV_fromIndices[i] : glm::vec2(0.f);
 		}
 	}
+}
+bool Object::LoadMeshCache(const char* path, glm::vec3& middlePoint)
+{
+	MeshCache* cache = new MeshCache;
+	if (!cache->Open(path))
+	{
+		delete cache;
+		return false;
+	}
+	const MeshCacheHeader& header = cache->header();
+	xMin = header.bounds[0];
+	xMax = header.bounds[1];
+	yMin = header.bounds[2];
+	yMax = header.bounds[3];
+	zMin = header.bounds[4];
+	zMax = header.bounds[5];
+	middlePoint = header.middle_point;
+
+	// kept mapped, Describe uploads straight from it and LoadCachedGeometry copies out of it on demand
+	delete m_mesh_cache;
+	m_mesh_cache = cache;
 	return true;
 }
+void Object::LoadCachedGeometry()
+{
+	if (!m_mesh_cache)
+		return;
+	const MeshCacheHeader& header = m_mesh_cache->header();
+	// the cache keeps one uv per vertex, so that is the vt list and each corner's uv index is its vertex index
+	const MeshVertex* vertices = m_mesh_cache->vertices();
+	obj_vertices.resize(header.vertex_count);
+	vertexNormals.resize(header.vertex_count);
+	textureUV.resize(header.vertex_count);
+	for (unsigned i = 0; i < header.vertex_count; ++i)
+	{
+		obj_vertices[i] = vertices[i].position;
+		vertexNormals[i] = vertices[i].normal;
+		textureUV[i] = vertices[i].uv;
+	}
+	textureUV_fromIndices = textureUV;
+	if (header.index_size == 2)
+	{
+		const unsigned short* indices = static_cast<const unsigned short*>(m_mesh_cache->indices());
+		obj_indices.assign(indices, indices + header.index_count);
+	}
+	else
+	{
+		const unsigned* indices = static_cast<const unsigned*>(m_mesh_cache->indices());
+		obj_indices.assign(indices, indices + header.index_count);
+	}
+	test_indices = obj_indices;
+
+	// from here on the copies are the mesh, Describe interleaves them again
+	delete m_mesh_cache;
+	m_mesh_cache = nullptr;
+}
+void Object::WriteMeshCache(const char* path, const glm::vec3& middlePoint) const
+{
+	std::vector<MeshVertex> vertices;
+	Interleave(*this, vertices);
+	const float bounds[6] = { xMin, xMax, yMin, yMax, zMin, zMax };
+	if (!MeshCache::Write(path, bounds, middlePoint, vertices, obj_indices))
+		std::cout << "Could not write the mesh cache of " << path << std::endl;
+}
+void Object::DescribeMesh()
+{
+	std::vector<MeshVertex> interleaved;
+	const void* vertices;
+	const void* indices = nullptr;
+	size_t vertex_count, index_count = 0, index_size = 0;
+	if (m_mesh_cache)
+	{
+		const MeshCacheHeader& header = m_mesh_cache->header();
+		vertices = m_mesh_cache->vertices();
+		indices = m_mesh_cache->indices();
+		vertex_count = header.vertex_count;
+		index_count = header.index_count;
+		index_size = header.index_size;
+	}
+	else
+	{
+		Interleave(*this, interleaved);
+		vertices = interleaved.empty() ? nullptr : &interleaved[0];
+		vertex_count = interleaved.size();
+	}
+
+	const GLsizei stride = sizeof(MeshVertex);
+	glBindVertexArray(m_vao);
+	glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+	glBufferData(GL_ARRAY_BUFFER, vertex_count * sizeof(MeshVertex), vertices, GL_STATIC_DRAW);
+
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(offsetof(MeshVertex, position)));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(offsetof(MeshVertex, uv)));
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(offsetof(MeshVertex, normal)));
+	glDisableVertexAttribArray(3);
+
+	if (m_mesh_cache)
+	{
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_count * index_size, indices, GL_STATIC_DRAW);
+		m_elementSize = static_cast<unsigned>(index_count);
+		m_index_type = index_size == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+	}
+	else
+		UploadIndices();
+}
 void Object::makeSphere()
 {
 	obj_vertices.clear();
@@ -419,7 +755,15 @@ void Object::makePlain()
 	Describe();
 }
 
-void Object::render_objs(Camera* camera, Shader* shader, glm::vec3 pos, float aspect, bool draw_line)
+void Object::UpdateModel()
+{
+	glm::mat4 identity_translate(1.0);
+	glm::mat4 identity_scale(1.0);
+	glm::mat4 identity_rotation(1.0);
+
+	m_model = glm::translate(identity_translate, position) * glm::scale(identity_scale, scale) * glm::rotate(identity_rotation, rotation, axis);
+}
+void Object::render_objs(Shader* shader, glm::vec3 pos, bool draw_line)
 {
 	glm::mat4 identity_translate(1.0);
 	glm::mat4 identity_scale(1.0);
@@ -427,58 +771,67 @@ void Object::render_objs(Camera* camera, Shader* shader, glm::vec3 pos, float as
 
 	// glm::vec3(0.f,0.f,1.f)
 	m_model = glm::translate(identity_translate, pos) * glm::scale(identity_scale, scale) * glm::rotate(identity_rotation, rotation, axis);
-	glm::mat4 projection = glm::perspective(glm::radians(camera->zoom), aspect, 0.1f, 100.0f); // zoom = fov;
-	glm::mat4 view = camera->GetViewMatrix();
 
-	shader->SetMat4("projection", projection);
-	shader->SetMat4("model", m_model);
-	shader->SetMat4("view", view);
+	shader->SetMat4(shader->Common().model, m_model);
+	shader->SetBool(shader->Common().octahedral_normals, m_packed);
 
 	glBindVertexArray(m_vao);
 	if(draw_line)
-		glDrawElements(GL_LINE_STRIP, m_elementSize, GL_UNSIGNED_INT, 0);
+		glDrawElements(GL_LINE_STRIP, m_elementSize, m_index_type, 0);
 	else
-		glDrawElements(GL_TRIANGLE_STRIP, m_elementSize, GL_UNSIGNED_INT, 0);
+		glDrawElements(GL_TRIANGLE_STRIP, m_elementSize, m_index_type, 0);
 	glBindVertexArray(0);
+	if (m_stream_ptr)
+		FenceStream();
 }
-void Object::render_diff_properties(Camera* camera, Shader* shader, glm::vec3 pos, float aspect)
+void Object::render_diff_properties(Shader* shader, glm::vec3 pos)
 {
 	glm::mat4 identity_translate(1.0);
 	glm::mat4 identity_scale(1.0);
 	glm::mat4 identity_rotation(1.0);
 
-	// glm::vec3(0.f,0.f,1.f)
-	glm::mat4 projection = glm::perspective(glm::radians(camera->zoom), aspect, 0.1f, 100.0f); // zoom = fov;
-	glm::mat4 view = camera->GetViewMatrix();
-
-	shader->SetMat4("projection", projection);
-	shader->SetMat4("view", view);
-
-	glBindVertexArray(m_vao);
-
-	for (int row = 0; row < nrRows; ++row)
+	glm::mat4 base = glm::translate(identity_translate, pos) * glm::scale(identity_scale, scale) * glm::rotate(identity_rotation, rotation, axis);
+	InstanceSweep sweep = { base, nrRows, nrColumns, spacing, m_textype };
+	// the sweep stands still, it is built and uploaded once and again only after something it comes from changed
+	if (!m_sweep_count || !(sweep == m_sweep))
 	{
-		shader->SetFloat("metallic_val", (float)row / (float)nrRows);
-		for (int col = 0; col < nrColumns; ++col)
+		std::vector<InstanceData> instances;
+		instances.reserve(nrRows * nrColumns);
+		for (int row = 0; row < nrRows; ++row)
 		{
-			// we clamp the roughness to 0.025 - 1.0 as perfectly smooth surfaces (roughness of 0.0) tend to look a bit off
-			// on direct lighting.
-			shader->SetFloat("roughness_val", glm::clamp((float)col / (float)nrColumns, 0.05f, 1.0f));
-
-			m_model = glm::translate(identity_translate, pos) * glm::scale(identity_scale, scale) * glm::rotate(identity_rotation, rotation, axis);
-			m_model = glm::translate(m_model, glm::vec3(
-				(float)(col - (nrColumns / 2)) * spacing,
-				(float)(row - (nrRows / 2)) * spacing,
-				-2.0f
-			));
-			shader->SetMat4("model", m_model);
-			glDrawElements(GL_TRIANGLE_STRIP, m_elementSize, GL_UNSIGNED_INT, 0);
+			for (int col = 0; col < nrColumns; ++col)
+			{
+				InstanceData instance;
+				instance.model = glm::translate(base, glm::vec3(
+					(float)(col - (nrColumns / 2)) * spacing,
+					(float)(row - (nrRows / 2)) * spacing,
+					-2.0f
+				));
+				// we clamp the roughness to 0.025 - 1.0 as perfectly smooth surfaces (roughness of 0.0) tend to look a bit off
+				// on direct lighting.
+				instance.params = glm::vec4((float)row / (float)nrRows, glm::clamp((float)col / (float)nrColumns, 0.05f, 1.0f), (float)m_textype, 0.f);
+				instances.push_back(instance);
+			}
 		}
+		m_sweep_count = static_cast<unsigned>(instances.size());
+		if (instances.empty())
+			return;
+		m_sweep = sweep;
+		m_sweep_last = instances.back().model;
+
+		if (!m_instance_buffer)
+			glGenBuffers(1, &m_instance_buffer);
+		glBindBuffer(GL_ARRAY_BUFFER, m_instance_buffer);
+		glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(InstanceData), &instances[0], GL_STATIC_DRAW);
 	}
-	glBindVertexArray(0);
+	m_model = m_sweep_last;
 
+	// the sweep replaces metallic_val and roughness_val per instance
+	shader->SetBool(shader->Common().instance_material, true);
+	render_instances(shader, m_instance_buffer, 0, m_sweep_count, GL_TRIANGLE_STRIP);
+	shader->SetBool(shader->Common().instance_material, false);
 }
-void Object::render_lights(Camera* camera, Shader* shader, glm::vec3 pos, float aspect)
+void Object::render_lights(Shader* shader, glm::vec3 pos)
 {
 	const static glm::vec3 up(0, 1, 0);
 
@@ -487,17 +840,47 @@ void Object::render_lights(Camera* camera, Shader* shader, glm::vec3 pos, float
 	glm::mat4 identity_rotation(1.0);
 
 	glm::mat4 model = glm::translate(identity_translate, pos) * glm::scale(identity_scale, scale) * glm::rotate(identity_rotation, rotation, up);
-	glm::mat4 projection = glm::perspective(glm::radians(camera->zoom), aspect, 0.1f, 100.0f);
-	glm::mat4 view = camera->GetViewMatrix();
 
-	shader->SetMat4("model", model);
-	shader->SetMat4("projection", projection);
-	shader->SetMat4("view", view);
+	shader->SetMat4(shader->Common().model, model);
+	shader->SetBool(shader->Common().octahedral_normals, m_packed);
 
 	glBindVertexArray(m_vao);
-	glDrawElements(GL_TRIANGLES, m_elementSize, GL_UNSIGNED_INT, nullptr);
+	glDrawElements(GL_TRIANGLES, m_elementSize, m_index_type, nullptr);
 	glBindVertexArray(0);
 }
+void Object::render_instances(Shader* shader, unsigned buffer, unsigned first, unsigned count, unsigned mode)
+{
+	if (!m_vao || !count)
+		return;
+	shader->SetBool(shader->Common().octahedral_normals, m_packed);
+	shader->SetBool(shader->Common().instanced, true);
+
+	glBindVertexArray(m_vao);
+	AttachInstances(buffer);
+	glDrawElementsInstancedBaseInstance(mode, m_elementSize, m_index_type, nullptr, count, first);
+	glBindVertexArray(0);
+	shader->SetBool(shader->Common().instanced, false);
+	if (m_stream_ptr)
+		FenceStream();
+}
+void Object::AttachInstances(unsigned buffer)
+{
+	if (m_instance_attached == buffer)
+		return;
+	const GLsizei stride = sizeof(InstanceData);
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+	for (unsigned column = 0; column < 4; ++column)
+	{
+		glEnableVertexAttribArray(INSTANCE_ATTRIBUTE + column);
+		glVertexAttribPointer(INSTANCE_ATTRIBUTE + column, 4, GL_FLOAT, GL_FALSE, stride,
+			reinterpret_cast<void*>(offsetof(InstanceData, model) + column * sizeof(glm::vec4)));
+		glVertexAttribDivisor(INSTANCE_ATTRIBUTE + column, 1);
+	}
+	glEnableVertexAttribArray(INSTANCE_ATTRIBUTE + 4);
+	glVertexAttribPointer(INSTANCE_ATTRIBUTE + 4, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(offsetof(InstanceData, params)));
+	glVertexAttribDivisor(INSTANCE_ATTRIBUTE + 4, 1);
+	m_instance_attached = buffer;
+}
 unsigned int Object::loadTexture(const char* path)
 {
 	unsigned int textureID;
@@ -565,12 +948,15 @@ void Object::LoadTGAFile(std::vector<std::string> faces)
 }
 unsigned int loadTexture_Environment(const char* path)
 {
-	stbi_set_flip_vertically_on_load(true);
 	int width, height, nrComponents;
 	float* data = stbi_loadf(path, &width, &height, &nrComponents, 0);
 	unsigned int hdrTexture = 0;
 	if (data)
 	{
+		// flipped by hand, stbi_set_flip_vertically_on_load is global and the material decode threads may be running
+		size_t row = static_cast<size_t>(width) * nrComponents;
+		for (int y = 0; y < height / 2; ++y)
+			std::swap_ranges(data + y * row, data + (y + 1) * row, data + (height - 1 - y) * row);
 		glGenTextures(1, &hdrTexture);
 		glBindTexture(GL_TEXTURE_2D, hdrTexture);
 
@@ -596,7 +982,7 @@ unsigned int loadTexture_Cubemap()
 	glBindTexture(GL_TEXTURE_CUBE_MAP, envCubemap);
 	for (unsigned int i = 0; i < 6; ++i)
 	{
-		glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, 512, 512, 0, GL_RGB, GL_FLOAT, nullptr);
+		glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, ENVIRONMENT_SIZE, ENVIRONMENT_SIZE, 0, GL_RGB, GL_FLOAT, nullptr);
 	}
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -642,7 +1028,7 @@ unsigned int loadTexture_irradianceMap(unsigned int& captureFBO, unsigned int& c
 	glBindTexture(GL_TEXTURE_CUBE_MAP, irradianceMap);
 	for (unsigned int i = 0; i < 6; ++i)
 	{
-		glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, 32, 32, 0, GL_RGB, GL_FLOAT, nullptr);
+		glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, IRRADIANCE_SIZE, IRRADIANCE_SIZE, 0, GL_RGB, GL_FLOAT, nullptr);
 	}
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -652,7 +1038,7 @@ unsigned int loadTexture_irradianceMap(unsigned int& captureFBO, unsigned int& c
 
 	glBindFramebuffer(GL_FRAMEBUFFER, captureFBO);
 	glBindRenderbuffer(GL_RENDERBUFFER, captureRBO);
-	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, 32, 32);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, IRRADIANCE_SIZE, IRRADIANCE_SIZE);
 
 	return irradianceMap;
 }
@@ -663,7 +1049,7 @@ unsigned int loadTexture_prefilterMap()
 	glBindTexture(GL_TEXTURE_CUBE_MAP, prefilterMap);
 	for (unsigned int i = 0; i < 6; ++i)
 	{
-		glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, 128, 128, 0, GL_RGB, GL_FLOAT, nullptr);
+		glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, PREFILTER_SIZE, PREFILTER_SIZE, 0, GL_RGB, GL_FLOAT, nullptr);
 	}
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -682,12 +1068,12 @@ void simulate_prefilter(Shader* prefilterShader, unsigned prefilterMap, unsigned
 	glBindTexture(GL_TEXTURE_CUBE_MAP, envCubemap);
 
 	glBindFramebuffer(GL_FRAMEBUFFER, captureFBO);
-	unsigned int maxMipLevels = 5;
+	unsigned int maxMipLevels = PREFILTER_LEVELS;
 	for (unsigned int mip = 0; mip < maxMipLevels; ++mip)
 	{
 		// reisze framebuffer according to mip-level size.
-		unsigned int mipWidth = static_cast<unsigned>(128 * std::pow(0.5, mip));
-		unsigned int mipHeight = static_cast<unsigned>(128 * std::pow(0.5, mip));
+		unsigned int mipWidth = static_cast<unsigned>(PREFILTER_SIZE * std::pow(0.5, mip));
+		unsigned int mipHeight = static_cast<unsigned>(PREFILTER_SIZE * std::pow(0.5, mip));
 		glBindRenderbuffer(GL_RENDERBUFFER, captureRBO);
 		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, mipWidth, mipHeight);
 		glViewport(0, 0, mipWidth, mipHeight);
@@ -713,25 +1099,32 @@ unsigned int loadTexture_LUT(Shader* brdfShader, unsigned captureFBO, unsigned c
 
 	// pre-allocate enough memory for the LUT texture.
 	glBindTexture(GL_TEXTURE_2D, brdfLUTTexture);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16F, 512, 512, 0, GL_RG, GL_FLOAT, 0);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16F, BRDF_LUT_SIZE, BRDF_LUT_SIZE, 0, GL_RG, GL_FLOAT, 0);
 	// be sure to set wrapping mode to GL_CLAMP_TO_EDGE
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
+	// baked once, later runs and scene switches load it
+	std::vector<std::string> sources = { "ShaderCodes\\brdf.vs", "ShaderCodes\\brdf.fs" };
+	IblCache::Layout layout = { GL_TEXTURE_2D, GL_RG16F, { { 0, 0, BRDF_LUT_SIZE } } };
+	if (IblCache::Load(BRDF_LUT_CACHE, sources, layout, &brdfLUTTexture))
+		return brdfLUTTexture;
+
 	// then re-configure capture framebuffer object and render screen-space quad with BRDF shader.
 	glBindFramebuffer(GL_FRAMEBUFFER, captureFBO);
 	glBindRenderbuffer(GL_RENDERBUFFER, captureRBO);
-	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, 512, 512);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, BRDF_LUT_SIZE, BRDF_LUT_SIZE);
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, brdfLUTTexture, 0);
 
-	glViewport(0, 0, 512, 512);
+	glViewport(0, 0, BRDF_LUT_SIZE, BRDF_LUT_SIZE);
 	brdfShader->Use();
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	renderQuad();
 
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	IblCache::Write(BRDF_LUT_CACHE, sources, layout, &brdfLUTTexture);
 
 	return brdfLUTTexture;
 }
@@ -743,77 +1136,36 @@ void InitFrameBuffer(Shader* equirectangularToCubmapShader, Shader* irradianceSh
 
 	glBindFramebuffer(GL_FRAMEBUFFER, captureFBO);
 	glBindRenderbuffer(GL_RENDERBUFFER, captureRBO);
-	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, 512, 512);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, ENVIRONMENT_SIZE, ENVIRONMENT_SIZE);
 	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, captureRBO);
 
-	// pbr: load the HDR environment map
-	hdrTexture = loadTexture_Environment("models\\newport_loft.hdr");
-
 	envCubemap = loadTexture_Cubemap();
-
-	glm::mat4 captureProjection = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 10.0f);
-	glm::mat4 captureViews[] =
-	{
-		glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(1.0f,  0.0f,  0.0f), glm::vec3(0.0f, -1.0f,  0.0f)),
-		glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(-1.0f,  0.0f,  0.0f), glm::vec3(0.0f, -1.0f,  0.0f)),
-		glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f,  1.0f,  0.0f), glm::vec3(0.0f,  0.0f,  1.0f)),
-		glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f,  0.0f), glm::vec3(0.0f,  0.0f, -1.0f)),
-		glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f,  0.0f,  1.0f), glm::vec3(0.0f, -1.0f,  0.0f)),
-		glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f,  0.0f, -1.0f), glm::vec3(0.0f, -1.0f,  0.0f))
-	};
-	equirectangularToCubmapShader->Use();
-	equirectangularToCubmapShader->SetInt("equirectangularMap", 0);
-	equirectangularToCubmapShader->SetMat4("projection", captureProjection);
-
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, hdrTexture);
-
-	glViewport(0, 0, 512, 512); // don't forget to configure the viewport to the capture dimensions.
-	glBindFramebuffer(GL_FRAMEBUFFER, captureFBO);
-
-	for (unsigned int i = 0; i < 6; ++i)
-	{
-		equirectangularToCubmapShader->SetMat4("view", captureViews[i]);
-		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, envCubemap, 0);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-		renderCube();
-	}
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-	// pbr: create an irradiance cubemap, and re-scale capture FBO to irradiance scale.
 	irradianceMap = loadTexture_irradianceMap(captureFBO, captureRBO);
-
-	irradianceShader->Use();
-	irradianceShader->SetInt("environmentMap", 0);
-	irradianceShader->SetMat4("projection", captureProjection);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, envCubemap);
-
-	glViewport(0, 0, 32, 32); // don't forget to configure the viewport to the capture dimensions.
-	glBindFramebuffer(GL_FRAMEBUFFER, captureFBO);
-	for (unsigned int i = 0; i < 6; ++i)
-	{
-		irradianceShader->SetMat4("view", captureViews[i]);
-		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, irradianceMap, 0);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-		renderCube();
-	}
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
 	prefilterMap = loadTexture_prefilterMap();
-	prefilterShader->Use();
-	prefilterShader->SetInt("environmentMap", 0);
-	prefilterShader->SetMat4("projection", captureProjection);
-
-	simulate_prefilter(prefilterShader, prefilterMap, captureFBO, captureRBO, envCubemap, captureViews);
+	// pbr: the HDR environment map is only loaded when the cache doesn't match it
+	hdrTexture = 0;
+	UpdateFrameBuffer(equirectangularToCubmapShader, irradianceShader, prefilterShader,
+		captureFBO, captureRBO, envCubemap, irradianceMap, prefilterMap, hdrTexture);
 
 	brdfLUTTexture = loadTexture_LUT(brdfShader, captureFBO, captureRBO);
 }
-void UpdateFrameBuffer(Shader* equirectangularToCubmapShader, Shader* irradianceShader, Shader* prefilterShader, Shader* brdfShader,
-	unsigned& captureFBO, unsigned& captureRBO, unsigned& envCubemap, unsigned& irradianceMap, unsigned& prefilterMap, unsigned& brdfLUTTexture, unsigned& hdrTexture)
+void UpdateFrameBuffer(Shader* equirectangularToCubmapShader, Shader* irradianceShader, Shader* prefilterShader,
+	unsigned& captureFBO, unsigned& captureRBO, unsigned& envCubemap, unsigned& irradianceMap, unsigned& prefilterMap, unsigned& hdrTexture)
 {
+	// keyed on the shaders too, editing one re-renders the maps on the next run
+	std::vector<std::string> sources = { ENVIRONMENT_HDR, "ShaderCodes\\cubemap.vs", "ShaderCodes\\equirectangular_to_cubemap.fs",
+		"ShaderCodes\\irradiance_convolution.fs", "ShaderCodes\\prefilter.fs" };
+	IblCache::Layout layout = { GL_TEXTURE_CUBE_MAP, GL_RGB16F, { { 0, 0, ENVIRONMENT_SIZE }, { 1, 0, IRRADIANCE_SIZE } } };
+	for (unsigned mip = 0; mip < PREFILTER_LEVELS; ++mip)
+		layout.levels.push_back({ 2, mip, static_cast<unsigned>(PREFILTER_SIZE) >> mip });
+	const unsigned textures[] = { envCubemap, irradianceMap, prefilterMap };
+	std::string path = std::string(ENVIRONMENT_HDR) + IBL_CACHE_EXTENSION;
+	if (IblCache::Load(path, sources, layout, textures))
+		return;
+
+	if (!hdrTexture)
+		hdrTexture = loadTexture_Environment(ENVIRONMENT_HDR);
+
 	glm::mat4 captureProjection = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 10.0f);
 	glm::mat4 captureViews[] =
 	{
@@ -832,8 +1184,10 @@ void UpdateFrameBuffer(Shader* equirectangularToCubmapShader, Shader* irradiance
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_2D, hdrTexture);
 
-	glViewport(0, 0, 512, 512); // don't forget to configure the viewport to the capture dimensions.
+	glViewport(0, 0, ENVIRONMENT_SIZE, ENVIRONMENT_SIZE); // don't forget to configure the viewport to the capture dimensions.
 	glBindFramebuffer(GL_FRAMEBUFFER, captureFBO);
+	glBindRenderbuffer(GL_RENDERBUFFER, captureRBO);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, ENVIRONMENT_SIZE, ENVIRONMENT_SIZE);
 
 	for (unsigned int i = 0; i < 6; ++i)
 	{
@@ -851,8 +1205,9 @@ void UpdateFrameBuffer(Shader* equirectangularToCubmapShader, Shader* irradiance
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_CUBE_MAP, envCubemap);
 
-	glViewport(0, 0, 32, 32); // don't forget to configure the viewport to the capture dimensions.
+	glViewport(0, 0, IRRADIANCE_SIZE, IRRADIANCE_SIZE); // don't forget to configure the viewport to the capture dimensions.
 	glBindFramebuffer(GL_FRAMEBUFFER, captureFBO);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, IRRADIANCE_SIZE, IRRADIANCE_SIZE);
 
 	for (unsigned int i = 0; i < 6; ++i)
 	{
@@ -872,15 +1227,9 @@ void UpdateFrameBuffer(Shader* equirectangularToCubmapShader, Shader* irradiance
 
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-}
-void InitSkybox(Shader* backgroundShader, Shader* pbrshader, Camera* camera, float width, float height)
-{
-	// initialize static shader uniforms before rendering
-	glm::mat4 projection = glm::perspective(glm::radians(camera->zoom), width / height, 0.1f, 100.0f);
-	pbrshader->Use();
-	pbrshader->SetMat4("projection", projection);
-	backgroundShader->Use();
-	backgroundShader->SetMat4("projection", projection);
+	// a missing HDR renders black, not worth caching
+	if (hdrTexture)
+		IblCache::Write(path, sources, layout, textures);
 }
 
 // renderCube() renders a 1x1 3D cube in NDC.
@@ -996,10 +1345,9 @@ void DeleteBuffers()
 	if (cubeVBO)
 		glDeleteBuffers(1, &cubeVBO);
 }
-void renderSkybox(Shader* backgroundShader, Camera* camera, unsigned& envCubemap, unsigned& irradianceMap)
+void renderSkybox(Shader* backgroundShader, unsigned& envCubemap, unsigned& irradianceMap)
 {
 	backgroundShader->Use();
-	backgroundShader->SetMat4("view", camera->GetViewMatrix());
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_CUBE_MAP, envCubemap);
 	//glBindTexture(GL_TEXTURE_CUBE_MAP, irradianceMap); // display irradiance map
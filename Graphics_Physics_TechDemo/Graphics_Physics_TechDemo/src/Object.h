@@ -21,8 +21,19 @@ End Header --------------------------------------------------------*/
 #include <map>
 #include <string>
 
-class Camera;
+// frames in flight of a streamed object, each one writes its own slot of the ring
+#define STREAM_FRAMES 3
+// first attribute of InstanceData, model takes four locations and params the one after
+#define INSTANCE_ATTRIBUTE 4
+// IBL texture sizes, part of what the IBL caches are matched on
+#define ENVIRONMENT_SIZE 512
+#define IRRADIANCE_SIZE 32
+#define PREFILTER_SIZE 128
+#define PREFILTER_LEVELS 5
+#define BRDF_LUT_SIZE 512
+
 class Shader;
+class MeshCache;
 
 typedef enum ObjShape {
 	O_PLANE,
@@ -45,6 +56,13 @@ typedef enum TexType {
 	GOLD,
 }TextureType;
 
+// what render_instances reads per instance
+struct InstanceData {
+	glm::mat4 model;
+	// metallic, roughness and material layer for pbr_texture.fs, the color for light.fs
+	glm::vec4 params;
+};
+
 class Object 
 {
 private:
@@ -53,6 +71,66 @@ private:
 	int width, height;
 	float xMax, xMin, yMax, yMin, zMax, zMin;
 
+	// ring of STREAM_FRAMES slots of positions followed by normals, mapped for the object's lifetime
+	unsigned m_stream_buffer = 0;
+	unsigned char* m_stream_ptr = nullptr;
+	size_t m_stream_slot = 0;
+	size_t m_stream_normal_offset = 0;
+	unsigned m_stream_frame = 0;
+	void* m_stream_fence[STREAM_FRAMES] = { nullptr }; // GLsync of the last draw reading each slot
+
+	void FenceStream();
+
+	// O_OBJ meshes are drawn from one interleaved buffer, straight from the mapped cache when there is one.
+	// A cache hit leaves the CPU geometry empty until LoadCachedGeometry
+	MeshCache* m_mesh_cache = nullptr;
+	unsigned m_index_type = 0;
+	bool LoadMeshCache(const char* path, glm::vec3& middlePoint);
+	void WriteMeshCache(const char* path, const glm::vec3& middlePoint) const;
+	void DescribeMesh();
+
+	// built-in shapes are drawn from one packed buffer unless they are streamed
+	bool m_packed = false;
+	bool m_dynamic = false;
+	bool DescribePacked();
+	// 16 bit when every vertex fits
+	void UploadIndices();
+
+	// instance buffer the vao's attributes point at, and the one render_diff_properties fills
+	unsigned m_instance_attached = 0;
+	unsigned m_instance_buffer = 0;
+	void AttachInstances(unsigned buffer);
+
+	// what m_instance_buffer was last filled from, the sweep is only rebuilt when one of these changes
+	struct InstanceSweep {
+		glm::mat4 base;
+		int rows, columns;
+		float spacing;
+		TextureType textype;
+		bool operator==(const InstanceSweep& other) const {
+			return base == other.base && rows == other.rows && columns == other.columns
+				&& spacing == other.spacing && textype == other.textype;
+		}
+	};
+	InstanceSweep m_sweep = {};
+	// instances in m_instance_buffer, 0 until the first upload
+	unsigned m_sweep_count = 0;
+	glm::mat4 m_sweep_last = glm::mat4(1.f);
+
+protected:
+	// triangles as vertex triples, and for every vertex the triangles around it (CSR: the faces of v are
+	// m_vertex_faces[m_vertex_face_start[v] .. m_vertex_face_start[v + 1]])
+	std::vector<unsigned> m_faces;
+	std::vector<unsigned> m_vertex_face_start;
+	std::vector<unsigned> m_vertex_faces;
+	// vertices at the same place (sphere seam and poles) take the faces of the first of them
+	std::vector<unsigned> m_normal_weld;
+	std::vector<glm::vec3> m_face_normals;
+
+	// render buffers Describe fills, for writing them from the GPU
+	unsigned VertexBuffer() const { return m_vbo; }
+	unsigned NormalBuffer() const { return normalBuffer; }
+
 public:
 	Object(ObjectShape shape, glm::vec3 pos, glm::vec3 scale_, int dim);
 	~Object();
@@ -60,25 +138,33 @@ public:
 	void CreateObject(const char* path, glm::vec3 initial_position, glm::vec3 initial_scale);
 	void GenerateBuffers();
 	void Describe();
+	// switch positions and normals to the persistently mapped ring, Stream then rewrites only those
+	void MakeDynamic();
+	void Stream();
+	// build the vertex to face adjacency once, ComputeNormals then recomputes vertexNormals from obj_vertices,
+	// building it first if nothing has
+	void BuildNormalAdjacency();
+	void ComputeNormals();
+	// fill obj_vertices, vertexNormals, the uvs and the indices of a mesh cache hit, nothing otherwise
+	void LoadCachedGeometry();
+	// m_model from position, scale and rotation, as render_objs draws it
+	void UpdateModel();
 	bool loadOBJ(const char* path, glm::vec3& middlePoint);
 	void makeSphere();
 	void makePlain();
 
-	void render_objs(Camera* camera, Shader* shader, glm::vec3 pos, float aspect, bool draw_line);
-	void render_diff_properties(Camera* camera, Shader* shader, glm::vec3 pos, float aspect);
-	void render_lights(Camera* camera, Shader* shader, glm::vec3 pos, float aspect);
+	// view and projection come from the frame uniform block, only the model is set per draw
+	void render_objs(Shader* shader, glm::vec3 pos, bool draw_line);
+	void render_diff_properties(Shader* shader, glm::vec3 pos);
+	void render_lights(Shader* shader, glm::vec3 pos);
+	// count copies of this mesh in one draw, InstanceData [first, first + count) of buffer
+	void render_instances(Shader* shader, unsigned buffer, unsigned first, unsigned count, unsigned mode);
 	unsigned int loadTexture(const char* path);
 	void LoadTGAFile(std::vector<std::string> faces);
 
 	bool loadPPM(const char* path, std::vector<glm::vec3>& values_);
 	void SendTextureInfo(Shader* shader, unsigned int& textureBuffer);
 	
-	unsigned int albedo = 0;
-	unsigned int normal = 0;
-	unsigned int metallic = 0;
-	unsigned int roughness = 0;
-	unsigned int ao = 0;
-
 	unsigned right, left, front, back, up, bottom; // indexes
 	int nrRows;
 	int nrColumns;
@@ -89,7 +175,6 @@ public:
 	std::vector<glm::vec2> textureUV;
 	std::vector<float> data;
 	glm::vec3 position, scale, color;
-	std::multimap<int, glm::vec3> faceNormals;
 	std::vector<glm::vec3> vertexNormals;
 	glm::vec3 middlePoint;
 	glm::mat4 m_model;
@@ -97,10 +182,15 @@ public:
 	float rotation;
 	int dimension;
 	ObjectShape m_shape;
+	// layer of the material arrays this object samples
 	TextureType m_textype;
 	glm::vec3 axis;
 
 	bool phy = false;
+	// set before creating objects when there is no GL context, only the geometry is built
+	static bool headless;
+	// Describe packs static spheres and planes into 16 bytes per vertex instead of three float buffers
+	static bool packed_vertices;
 
 	std::vector<unsigned> test_indices;
 	std::vector<glm::vec2> textureUV_fromIndices;
@@ -122,12 +212,12 @@ void simulate_prefilter(Shader* prefilterShader, unsigned prefilterMap, unsigned
 
 void InitFrameBuffer(Shader* equirectangularToCubmapShader, Shader* irradianceShader, Shader* prefilterShader, Shader* brdfShader,
 	unsigned& captureFBO, unsigned& captureRBO,	unsigned& envCubemap, unsigned& irradianceMap, unsigned& prefilterMap, unsigned& brdfLUTTexture, unsigned& hdrTexture);
-void UpdateFrameBuffer(Shader* equirectangularToCubmapShader, Shader* irradianceShader, Shader* prefilterShader, Shader* brdfShader,
-	unsigned& captureFBO, unsigned& captureRBO, unsigned& envCubemap, unsigned& irradianceMap, unsigned& prefilterMap, unsigned& brdfLUTTexture, unsigned& hdrTexture);
-void InitSkybox(Shader* backgroundShader, Shader* pbrshader, Camera* camera, float width, float height);
+// fills the allocated environment maps from their cache, or loads the HDR, renders them and writes the cache
+void UpdateFrameBuffer(Shader* equirectangularToCubmapShader, Shader* irradianceShader, Shader* prefilterShader,
+	unsigned& captureFBO, unsigned& captureRBO, unsigned& envCubemap, unsigned& irradianceMap, unsigned& prefilterMap, unsigned& hdrTexture);
 void renderCube();
 void renderQuad();
-void renderSkybox(Shader* backgroundShader, Camera* camera, unsigned& envCubemap, unsigned& irradianceMap);
+void renderSkybox(Shader* backgroundShader, unsigned& envCubemap, unsigned& irradianceMap);
 void DeleteBuffers();
 
 #endif
@@ -0,0 +1,118 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: Particle.h
+Purpose: Structure-of-arrays particle storage for softbody physics
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#pragma once
+
+#ifndef PARTICLE_H
+#define PARTICLE_H
+
+#include "glm/glm.hpp"
+#include <xmmintrin.h>
+#include <vector>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+// floats per widest SIMD register (AVX), arrays are padded to a multiple of it
+#define SIMD_WIDTH 8
+#define SIMD_ALIGNMENT 32
+
+template <typename T, std::size_t Alignment>
+struct AlignedAllocator {
+	typedef T value_type;
+
+	template <typename U>
+	struct rebind { typedef AlignedAllocator<U, Alignment> other; };
+
+	AlignedAllocator() {}
+	template <typename U>
+	AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+	T* allocate(std::size_t n)
+	{
+		void* ptr = _mm_malloc(n * sizeof(T), Alignment);
+		if (ptr == nullptr)
+			throw std::bad_alloc();
+		return static_cast<T*>(ptr);
+	}
+	void deallocate(T* ptr, std::size_t) { _mm_free(ptr); }
+
+	template <typename U>
+	bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+	template <typename U>
+	bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+typedef std::vector<float, AlignedAllocator<float, SIMD_ALIGNMENT>> AlignedFloats;
+
+// x, y, z are stored in separate arrays so integration loops stream each component.
+// Lanes past size() are zero padding and never read back as particles.
+class ParticleArray {
+public:
+	ParticleArray() : m_count(0) {}
+
+	void assign(unsigned count, const glm::vec3& value)
+	{
+		resize(count);
+		for (unsigned i = 0; i < count; ++i)
+			set(i, value);
+	}
+	void assign(const std::vector<glm::vec3>& values)
+	{
+		resize(static_cast<unsigned>(values.size()));
+		for (unsigned i = 0; i < m_count; ++i)
+			set(i, values[i]);
+	}
+
+	void swap(ParticleArray& other)
+	{
+		x.swap(other.x);
+		y.swap(other.y);
+		z.swap(other.z);
+		std::swap(m_count, other.m_count);
+	}
+
+	unsigned size() const { return m_count; }
+	unsigned padded_size() const { return static_cast<unsigned>(x.size()); }
+	bool empty() const { return m_count == 0; }
+
+	glm::vec3 get(unsigned i) const { return glm::vec3(x[i], y[i], z[i]); }
+	void set(unsigned i, const glm::vec3& v)
+	{
+		x[i] = v.x;
+		y[i] = v.y;
+		z[i] = v.z;
+	}
+	void add(unsigned i, const glm::vec3& v)
+	{
+		x[i] += v.x;
+		y[i] += v.y;
+		z[i] += v.z;
+	}
+
+	AlignedFloats x;
+	AlignedFloats y;
+	AlignedFloats z;
+private:
+	void resize(unsigned count)
+	{
+		m_count = count;
+		unsigned padded = (count + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+		x.assign(padded, 0.f);
+		y.assign(padded, 0.f);
+		z.assign(padded, 0.f);
+	}
+
+	unsigned m_count;
+};
+
+#endif
@@ -0,0 +1,234 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: ParticleKernels.cpp
+Purpose: Scalar, SSE2 and AVX2 particle kernels with runtime dispatch
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#include "ParticleKernels.h"
+#include <emmintrin.h>
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TARGET_AVX2
+#else
+#include <cpuid.h>
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+// no fused multiply-add on purpose: every path rounds like the scalar one, so results match bit for bit
+
+namespace
+{
+	SimdLevel DetectSimdLevel()
+	{
+		int info[4] = { 0 };
+#if defined(_MSC_VER)
+		__cpuid(info, 0);
+		int max_leaf = info[0];
+		__cpuid(info, 1);
+#else
+		unsigned a = 0, b = 0, c = 0, d = 0;
+		if (!__get_cpuid(0, &a, &b, &c, &d))
+			return SIMD_SCALAR;
+		int max_leaf = static_cast<int>(a);
+		if (!__get_cpuid(1, &a, &b, &c, &d))
+			return SIMD_SCALAR;
+		info[0] = a; info[1] = b; info[2] = c; info[3] = d;
+#endif
+		bool sse2 = (info[3] & (1 << 26)) != 0;
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		bool avx = (info[2] & (1 << 28)) != 0;
+		if (!sse2)
+			return SIMD_SCALAR;
+		if (!osxsave || !avx || max_leaf < 7)
+			return SIMD_SSE2;
+
+		// the os has to save ymm registers on context switch
+#if defined(_MSC_VER)
+		unsigned long long xcr0 = _xgetbv(0);
+#else
+		unsigned xcr_lo, xcr_hi;
+		__asm__("xgetbv" : "=a"(xcr_lo), "=d"(xcr_hi) : "c"(0));
+		unsigned long long xcr0 = (static_cast<unsigned long long>(xcr_hi) << 32) | xcr_lo;
+#endif
+		if ((xcr0 & 0x6) != 0x6)
+			return SIMD_SSE2;
+
+#if defined(_MSC_VER)
+		__cpuidex(info, 7, 0);
+#else
+		__cpuid_count(7, 0, a, b, c, d);
+		info[1] = b;
+#endif
+		bool avx2 = (info[1] & (1 << 5)) != 0;
+		return avx2 ? SIMD_AVX2 : SIMD_SSE2;
+	}
+
+	const SimdLevel supported_level = DetectSimdLevel();
+	SimdLevel current_level = supported_level;
+
+	// verlet
+	void VerletScalar(float* pos, float* old, const float* acc, unsigned n, float f, float dt)
+	{
+		for (unsigned i = 0; i < n; ++i)
+		{
+			float temp = pos[i];
+			pos[i] += f * temp - f * old[i] + acc[i] * dt * dt;
+			old[i] = temp;
+		}
+	}
+	void VerletSSE2(float* pos, float* old, const float* acc, unsigned n, float f, float dt)
+	{
+		const __m128 vf = _mm_set1_ps(f);
+		const __m128 vdt = _mm_set1_ps(dt);
+		for (unsigned i = 0; i < n; i += 4)
+		{
+			__m128 temp = _mm_load_ps(pos + i);
+			__m128 prev = _mm_load_ps(old + i);
+			__m128 a = _mm_load_ps(acc + i);
+			__m128 step = _mm_sub_ps(_mm_mul_ps(vf, temp), _mm_mul_ps(vf, prev));
+			step = _mm_add_ps(step, _mm_mul_ps(_mm_mul_ps(a, vdt), vdt));
+			_mm_store_ps(pos + i, _mm_add_ps(temp, step));
+			_mm_store_ps(old + i, temp);
+		}
+	}
+	TARGET_AVX2 void VerletAVX2(float* pos, float* old, const float* acc, unsigned n, float f, float dt)
+	{
+		const __m256 vf = _mm256_set1_ps(f);
+		const __m256 vdt = _mm256_set1_ps(dt);
+		for (unsigned i = 0; i < n; i += 8)
+		{
+			__m256 temp = _mm256_load_ps(pos + i);
+			__m256 prev = _mm256_load_ps(old + i);
+			__m256 a = _mm256_load_ps(acc + i);
+			__m256 step = _mm256_sub_ps(_mm256_mul_ps(vf, temp), _mm256_mul_ps(vf, prev));
+			step = _mm256_add_ps(step, _mm256_mul_ps(_mm256_mul_ps(a, vdt), vdt));
+			_mm256_store_ps(pos + i, _mm256_add_ps(temp, step));
+			_mm256_store_ps(old + i, temp);
+		}
+		_mm256_zeroupper();
+	}
+
+	// bounds, x / y / z reduced in the same pass
+	void BoundsScalar(const float* x, const float* y, const float* z, unsigned begin, unsigned end,
+		glm::vec3& min, glm::vec3& max)
+	{
+		for (unsigned i = begin; i < end; ++i)
+		{
+			min.x = x[i] < min.x ? x[i] : min.x;
+			max.x = x[i] > max.x ? x[i] : max.x;
+			min.y = y[i] < min.y ? y[i] : min.y;
+			max.y = y[i] > max.y ? y[i] : max.y;
+			min.z = z[i] < min.z ? z[i] : min.z;
+			max.z = z[i] > max.z ? z[i] : max.z;
+		}
+	}
+	float HorizontalMin(__m128 v)
+	{
+		v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+		v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtss_f32(v);
+	}
+	float HorizontalMax(__m128 v)
+	{
+		v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+		v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtss_f32(v);
+	}
+	void BoundsSSE2(const float* x, const float* y, const float* z, unsigned count, glm::vec3& min, glm::vec3& max)
+	{
+		__m128 min_x = _mm_set1_ps(min.x), max_x = _mm_set1_ps(max.x);
+		__m128 min_y = _mm_set1_ps(min.y), max_y = _mm_set1_ps(max.y);
+		__m128 min_z = _mm_set1_ps(min.z), max_z = _mm_set1_ps(max.z);
+		unsigned body = count / 4 * 4;
+		for (unsigned i = 0; i < body; i += 4)
+		{
+			__m128 vx = _mm_load_ps(x + i);
+			__m128 vy = _mm_load_ps(y + i);
+			__m128 vz = _mm_load_ps(z + i);
+			min_x = _mm_min_ps(min_x, vx);
+			max_x = _mm_max_ps(max_x, vx);
+			min_y = _mm_min_ps(min_y, vy);
+			max_y = _mm_max_ps(max_y, vy);
+			min_z = _mm_min_ps(min_z, vz);
+			max_z = _mm_max_ps(max_z, vz);
+		}
+		min = glm::vec3(HorizontalMin(min_x), HorizontalMin(min_y), HorizontalMin(min_z));
+		max = glm::vec3(HorizontalMax(max_x), HorizontalMax(max_y), HorizontalMax(max_z));
+		BoundsScalar(x, y, z, body, count, min, max);
+	}
+	TARGET_AVX2 void BoundsAVX2(const float* x, const float* y, const float* z, unsigned count, glm::vec3& min, glm::vec3& max)
+	{
+		__m256 min_x = _mm256_set1_ps(min.x), max_x = _mm256_set1_ps(max.x);
+		__m256 min_y = _mm256_set1_ps(min.y), max_y = _mm256_set1_ps(max.y);
+		__m256 min_z = _mm256_set1_ps(min.z), max_z = _mm256_set1_ps(max.z);
+		unsigned body = count / 8 * 8;
+		for (unsigned i = 0; i < body; i += 8)
+		{
+			__m256 vx = _mm256_load_ps(x + i);
+			__m256 vy = _mm256_load_ps(y + i);
+			__m256 vz = _mm256_load_ps(z + i);
+			min_x = _mm256_min_ps(min_x, vx);
+			max_x = _mm256_max_ps(max_x, vx);
+			min_y = _mm256_min_ps(min_y, vy);
+			max_y = _mm256_max_ps(max_y, vy);
+			min_z = _mm256_min_ps(min_z, vz);
+			max_z = _mm256_max_ps(max_z, vz);
+		}
+		min.x = HorizontalMin(_mm_min_ps(_mm256_castps256_ps128(min_x), _mm256_extractf128_ps(min_x, 1)));
+		min.y = HorizontalMin(_mm_min_ps(_mm256_castps256_ps128(min_y), _mm256_extractf128_ps(min_y, 1)));
+		min.z = HorizontalMin(_mm_min_ps(_mm256_castps256_ps128(min_z), _mm256_extractf128_ps(min_z, 1)));
+		max.x = HorizontalMax(_mm_max_ps(_mm256_castps256_ps128(max_x), _mm256_extractf128_ps(max_x, 1)));
+		max.y = HorizontalMax(_mm_max_ps(_mm256_castps256_ps128(max_y), _mm256_extractf128_ps(max_y, 1)));
+		max.z = HorizontalMax(_mm_max_ps(_mm256_castps256_ps128(max_z), _mm256_extractf128_ps(max_z, 1)));
+		_mm256_zeroupper();
+		BoundsScalar(x, y, z, body, count, min, max);
+	}
+}
+
+SimdLevel GetSimdLevel()
+{
+	return current_level;
+}
+void SetSimdLevel(SimdLevel level)
+{
+	current_level = level < supported_level ? level : supported_level;
+}
+void IntegrateVerlet(ParticleArray& pos, ParticleArray& old, const ParticleArray& acc, float f, float dt)
+{
+	unsigned n = pos.padded_size();
+	float* p[3] = { pos.x.data(), pos.y.data(), pos.z.data() };
+	float* o[3] = { old.x.data(), old.y.data(), old.z.data() };
+	const float* a[3] = { acc.x.data(), acc.y.data(), acc.z.data() };
+	for (unsigned c = 0; c < 3; ++c)
+	{
+		if (current_level == SIMD_AVX2)
+			VerletAVX2(p[c], o[c], a[c], n, f, dt);
+		else if (current_level == SIMD_SSE2)
+			VerletSSE2(p[c], o[c], a[c], n, f, dt);
+		else
+			VerletScalar(p[c], o[c], a[c], n, f, dt);
+	}
+}
+void ComputeBounds(const ParticleArray& pos, unsigned count, glm::vec3& min, glm::vec3& max)
+{
+	if (count == 0)
+		return;
+	const float* x = pos.x.data();
+	const float* y = pos.y.data();
+	const float* z = pos.z.data();
+	min = max = pos.get(0);
+	if (current_level == SIMD_AVX2)
+		BoundsAVX2(x, y, z, count, min, max);
+	else if (current_level == SIMD_SSE2)
+		BoundsSSE2(x, y, z, count, min, max);
+	else
+		BoundsScalar(x, y, z, 0, count, min, max);
+}
@@ -0,0 +1,36 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: ParticleKernels.h
+Purpose: Prototype of SIMD particle kernels (verlet integration, bounds)
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#pragma once
+
+#ifndef PARTICLE_KERNELS_H
+#define PARTICLE_KERNELS_H
+
+#include "Particle.h"
+
+typedef enum SimdLevel {
+	SIMD_SCALAR,
+	SIMD_SSE2,
+	SIMD_AVX2,
+}SimdLevel;
+
+// detected once with CPUID, the kernels below dispatch on it
+SimdLevel GetSimdLevel();
+// force a lower level (e.g. for comparing against the scalar path), clamped to what the cpu supports
+void SetSimdLevel(SimdLevel level);
+
+// pos += f * pos - f * old + acc * dt * dt, old = previous pos, over the padded range
+void IntegrateVerlet(ParticleArray& pos, ParticleArray& old, const ParticleArray& acc, float f, float dt);
+// min / max of the first count particles
+void ComputeBounds(const ParticleArray& pos, unsigned count, glm::vec3& min, glm::vec3& max);
+
+#endif
@@ -12,33 +12,150 @@ Creation date: 9/20/2018
 End Header --------------------------------------------------------*/
 #include "Physics.h"
 #include "Base.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace
+{
+	double ElapsedMs(std::chrono::high_resolution_clock::time_point& since)
+	{
+		std::chrono::high_resolution_clock::time_point now = std::chrono::high_resolution_clock::now();
+		double ms = std::chrono::duration<double, std::milli>(now - since).count();
+		since = now;
+		return ms;
+	}
+}
+
+void Physics::push_object(SoftBodyPhysics* _obj)
+{
+	softbody_objs.push_back(_obj);
+	if (!gpu_allowed())
+		UseGpu(false);
+}
+bool Physics::UseGpu(bool enable)
+{
+	if (enable && !gpu_allowed())
+		return false;
+	bool all = true;
+	for (auto soft : softbody_objs)
+		all = soft->UseGpu(enable) && all;
+	return all;
+}
 
 void Physics::update(float dt)
 {
-	std::vector<SoftBodyPhysics*>::iterator it_soft = softbody_objs.begin();
-	for (; it_soft != softbody_objs.end(); ++it_soft)
-		(*it_soft)->Update(dt);
+	ThreadPool& pool = ThreadPool::Instance();
+	unsigned count = static_cast<unsigned>(softbody_objs.size());
+	// bodies switched one by one still can't meet another softbody on the GPU
+	if (!gpu_allowed())
+		UseGpu(false);
+	std::chrono::high_resolution_clock::time_point clock = std::chrono::high_resolution_clock::now();
+
+	// bodies don't share anything while integrating, one body per job
+	pool.ParallelFor(count, 1, [this, dt](unsigned begin, unsigned end) {
+		for (unsigned i = begin; i < end; ++i)
+			if (!softbody_objs[i]->on_gpu())
+				softbody_objs[i]->Update(dt);
+	});
+	m_timings.integrate = ElapsedMs(clock);
+
+	// only bodies with overlapping bounds reach the narrow phase, both orders like the full pairwise loop
+	m_broadphase.FindPairs(softbody_objs, m_soft_pairs);
+	m_soft_neighbors.resize(count);
+	for (auto& neighbors : m_soft_neighbors)
+		neighbors.clear();
+	for (auto& pair : m_soft_pairs)
+	{
+		m_soft_neighbors[pair.first].push_back(pair.second);
+		m_soft_neighbors[pair.second].push_back(pair.first);
+	}
+	for (auto& neighbors : m_soft_neighbors)
+		std::sort(neighbors.begin(), neighbors.end());
+	m_timings.broadphase = ElapsedMs(clock);
+
+	// rigid bodies fall a little for every softbody, done up front so the contact jobs only read them.
+	// Their planes come from m_model, so it is kept current here instead of only when drawn.
+	std::vector<Object*>::iterator it_rigid;
+	for (it_rigid = physics_objs.begin(); it_rigid < physics_objs.end(); ++it_rigid)
+	{
+		if ((*it_rigid)->phy)
+			(*it_rigid)->position += static_cast<float>(count) * 0.3f * glm::vec3(0, GRAVITY, 0)*dt;
+		(*it_rigid)->UpdateModel();
+	}
 
-	for (it_soft = softbody_objs.begin(); it_soft != softbody_objs.end(); ++it_soft)
+	// compute shader dispatches have to come from the thread owning the GL context
+	bool gpu_colliders = false;
+	for (auto soft : softbody_objs)
 	{
-		std::vector<SoftBodyPhysics*>::iterator it_soft2;
-		for (it_soft2 = softbody_objs.begin(); it_soft2 != softbody_objs.end(); ++it_soft2)
+		if (!soft->on_gpu())
+			continue;
+		if (!gpu_colliders)
 		{
-			if (it_soft == it_soft2)
-				continue;
-			(*it_soft)->CollisionResponseSoft(*it_soft2);
+			GpuSoftBody::BuildColliders(physics_objs, m_gpu_colliders);
+			gpu_colliders = true;
 		}
+		soft->UpdateGpu(dt, m_gpu_colliders);
+	}
+	if (gpu_colliders)
+		m_timings.integrate += ElapsedMs(clock);
 
-		std::vector<Object*>::iterator it_rigid;
-		for (it_rigid = physics_objs.begin(); it_rigid < physics_objs.end(); ++it_rigid)
+	// every body pushes its own copy of the particles against the others' positions from the end of Update,
+	// the copies are applied after all of them are done so no job reads what another one writes
+	pool.ParallelFor(count, 1, [this](unsigned begin, unsigned end) {
+		for (unsigned i = begin; i < end; ++i)
+			if (!softbody_objs[i]->on_gpu())
+				softbody_objs[i]->BeginContacts();
+	});
+	pool.ParallelFor(count, 1, [this](unsigned begin, unsigned end) {
+		for (unsigned i = begin; i < end; ++i)
 		{
-			if ((*it_rigid)->phy)
-				(*it_rigid)->position += 0.3f * glm::vec3(0, GRAVITY, 0)*dt;
-			(*it_soft)->CollisionResponseRigid(*it_rigid);
+			SoftBodyPhysics* soft = softbody_objs[i];
+			if (soft->on_gpu())
+				continue;
+			for (unsigned j : m_soft_neighbors[i])
+				soft->CollisionResponseSoft(softbody_objs[j]);
+			for (Object* rigid : physics_objs)
+				soft->CollisionResponseRigid(rigid);
 		}
-
-	}
+	});
+	pool.ParallelFor(count, 1, [this](unsigned begin, unsigned end) {
+		for (unsigned i = begin; i < end; ++i)
+			if (!softbody_objs[i]->on_gpu())
+				softbody_objs[i]->EndContacts();
+	});
+	m_timings.contacts = ElapsedMs(clock);
 }
 
+unsigned Physics::step(float frame_dt)
+{
+	m_accumulator += frame_dt;
+	unsigned max_steps = std::max(1u, static_cast<unsigned>(MAX_FRAME_TIME / m_step + 0.5f));
+	unsigned steps = 0;
+	while (m_accumulator >= m_step && steps < max_steps)
+	{
+		update(m_step);
+		m_accumulator -= m_step;
+		++steps;
+	}
+	// too slow to keep up, let the simulation fall behind instead of running ever more steps.
+	// Only whole steps are dropped, the fraction left keeps alpha where the next frame expects it
+	if (m_accumulator >= m_step)
+		m_accumulator = std::fmod(m_accumulator, m_step);
 
-
+	float alpha = get_alpha();
+	ThreadPool::Instance().ParallelFor(static_cast<unsigned>(softbody_objs.size()), 1, [this, alpha](unsigned begin, unsigned end) {
+		for (unsigned i = begin; i < end; ++i)
+		{
+			if (softbody_objs[i]->on_gpu())
+				continue;
+			softbody_objs[i]->Interpolate(alpha);
+			softbody_objs[i]->UpdateNormals();
+		}
+	});
+	for (auto soft : softbody_objs)
+		if (soft->on_gpu())
+			soft->Interpolate(alpha);
+	return steps;
+}
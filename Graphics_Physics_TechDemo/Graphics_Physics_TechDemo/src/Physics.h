@@ -17,28 +17,72 @@ End Header --------------------------------------------------------*/
 
 #include "glm/glm.hpp"
 #include <vector>
+#include <utility>
+#include "Broadphase.h"
+#include "GpuSoftBody.h"
 
 #define MIN_LEAF_SIZE 300
+// fixed simulation step and the most frame time one frame catches up on before the whole steps past it
+// are dropped, the step count follows from it so a smaller step still covers the same hitch
+#define PHYSICS_STEP (1.f / 60.f)
+#define MAX_FRAME_TIME 0.1f
 
 class Object;
 class SoftBodyPhysics;
 
+// wall time of the phases of the last update, in milliseconds
+struct PhysicsTimings {
+	double integrate;
+	double broadphase;
+	double contacts;
+};
+
 class Physics {
 public:
+	Physics() : m_step(PHYSICS_STEP), m_accumulator(0.f), m_timings() {}
+
 	void update(float dt);
+	// run as many fixed steps as frame_dt covers and interpolate the softbodies' vertices and normals for drawing.
+	// Returns how many steps ran.
+	unsigned step(float frame_dt);
+	void set_step(float step) { m_step = step; }
+	float get_step() const { return m_step; }
+	// time carried over to the next step call, always less than one step
+	float get_accumulator() const { return m_accumulator; }
+	// how far the drawn vertices are from the previous step to the current one, in [0, 1)
+	float get_alpha() const { return m_accumulator / m_step; }
+	const PhysicsTimings& timings() const { return m_timings; }
+
 	void push_object(Object* _obj) { physics_objs.push_back(_obj);}
-	void push_object(SoftBodyPhysics* _obj) { softbody_objs.push_back(_obj); }
+	// a second softbody moves the bodies off the compute path, see gpu_allowed
+	void push_object(SoftBodyPhysics* _obj);
+
+	// the compute path only has rigid contacts, so it is only offered while a single softbody has no
+	// other one to touch
+	bool gpu_allowed() const { return softbody_objs.size() == 1; }
+	// every softbody onto the compute path or back to the CPU, false if that is refused or unsupported
+	bool UseGpu(bool enable);
 
 	void delete_object(Object* obj);
 	bool empty() { return physics_objs.empty(); }
 	void clear_objects() {
 		physics_objs.clear();
 		softbody_objs.clear();
+		m_accumulator = 0.f;
 	};
 private:
 	std::vector<Object*> physics_objs;
 	std::vector<SoftBodyPhysics*> softbody_objs;
 
+	float m_step;
+	float m_accumulator;
+	PhysicsTimings m_timings;
+
+	Broadphase m_broadphase;
+	std::vector<std::pair<unsigned, unsigned>> m_soft_pairs;
+	// bodies each softbody has to be tested against, ascending
+	std::vector<std::vector<unsigned>> m_soft_neighbors;
+	std::vector<GpuCollider> m_gpu_colliders;
 };
 
 #endif // !PHYSICS_H
\ No newline at end of file
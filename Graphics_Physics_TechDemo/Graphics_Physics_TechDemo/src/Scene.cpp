@@ -13,9 +13,9 @@ End Header --------------------------------------------------------*/
 #include "Scene.h"
 #include "input.h"
 #include "glm/gtc/matrix_transform.hpp"
+#include <algorithm>
 #include <iostream>
 
-const float FRAME_LIMIT = 1.f / 59.f;
 const float PI = 4.0f * atan(1.0f);
 
 void Scene::Init(GLFWwindow* window, Camera* camera)
@@ -27,17 +27,16 @@ void Scene::Init(GLFWwindow* window, Camera* camera)
 	brdfShader.CreateShader("ShaderCodes\\brdf.vs", "ShaderCodes\\brdf.fs", nullptr);
 	prefilterShader.CreateShader("ShaderCodes\\cubemap.vs", "ShaderCodes\\prefilter.fs", nullptr);
 	lightShader.CreateShader("ShaderCodes\\pbr_texture.vs", "ShaderCodes\\light.fs", nullptr);
+	uniform_blocks.Init();
 
 	pbr_texture_shader.Use();
 	pbr_texture_shader.SetInt("irradianceMap", 0);
 	pbr_texture_shader.SetInt("prefilterMap", 1);
 	pbr_texture_shader.SetInt("brdfLUT", 2);
 
-	pbr_texture_shader.SetInt("albedo", 3);
-	pbr_texture_shader.SetInt("normal", 4);
-	pbr_texture_shader.SetInt("metallic", 5);
-	pbr_texture_shader.SetInt("roughness", 6);
-	pbr_texture_shader.SetInt("ao", 7);
+	pbr_texture_shader.SetInt("albedoMap", MATERIAL_TEXTURE_UNIT);
+	pbr_texture_shader.SetInt("normalMap", MATERIAL_TEXTURE_UNIT + 1);
+	pbr_texture_shader.SetInt("ormMap", MATERIAL_TEXTURE_UNIT + 2);
 
 	backgroundShader.Use();
 	backgroundShader.SetInt("environmentMap", 0);
@@ -48,22 +47,10 @@ void Scene::Init(GLFWwindow* window, Camera* camera)
 	// pbr: setup framebuffer
 	InitFrameBuffer(&equirectangularToCubmapShader, &irradianceShader, &prefilterShader, &brdfShader,
 		captureFBO, captureRBO, envCubemap, irradianceMap, prefilterMap, brdfLUTTexture, hdrTexture);
-	InitSkybox(&backgroundShader, &pbr_texture_shader, camera, (float)width, (float)height);
 
 	ResizeFrameBuffer(window);
 
-	if (curr_scene == 0)
-		Scene0Init(camera);
-	else if (curr_scene == 1)
-		Scene1Init(camera);
-	else if (curr_scene == 2)
-		Scene2Init(camera);
-	else if (curr_scene == 3)
-		Scene3Init(camera);
-	else if (curr_scene == 4)
-		Scene4Init(camera);
-	else if (curr_scene == 5)
-		Scene5Init(camera);
+	InitContent(camera);
 }
 void Scene::Update(GLFWwindow* window, Camera* camera, float dt)
 {
@@ -71,9 +58,11 @@ void Scene::Update(GLFWwindow* window, Camera* camera, float dt)
 	deltaTime = currFrame - lastFrame;
 	lastFrame = currFrame;
 
-	ImGuiUpdate(window, camera, deltaTime);
+	ImGuiUpdate(camera, deltaTime);
 
 	ProcessInput(camera, window, deltaTime);
+	// material textures decoded since the last frame replace their placeholders
+	materials.Update();
 
 	if (curr_scene == 0)
 		Scene0Draw(window, camera, deltaTime);
@@ -90,78 +79,24 @@ void Scene::Update(GLFWwindow* window, Camera* camera, float dt)
 
 	ImGuirender();
 }
+void Scene::PushContent(const SceneContent& content)
+{
+	for (auto rigid : content.rigid)
+	{
+		m_physics.push_object(rigid);
+		pbr_obj.push_back(rigid);
+	}
+	for (auto soft : content.softbody)
+	{
+		m_physics.push_object(soft);
+		softbody_obj.push_back(soft);
+	}
+}
 void Scene::Scene0Init(Camera* camera)
 {
-	Object* rigid_plane = new Object(O_PLANE, glm::vec3(4.f, -4.f, 1.f), glm::vec3(7.f, 1.f, 0.5f), P_DIMENSION);
-	rigid_plane->rotation = 1.f;
-	m_physics.push_object(rigid_plane);
-	pbr_obj.push_back(rigid_plane);
-
-	Object* rigid_plane_1 = new Object(O_PLANE, glm::vec3(4.f, -4.f, 2.f), glm::vec3(7.f, 1.f, 0.5f), P_DIMENSION);
-	rigid_plane_1->rotation = 1.f;
-	m_physics.push_object(rigid_plane_1);
-	pbr_obj.push_back(rigid_plane_1);
-
-	Object* rigid_plane_2 = new Object(O_PLANE, glm::vec3(1.3f, -7.f, 0.5f), glm::vec3(4.f, 1.f, 4.f), P_DIMENSION); // 2
-	rigid_plane_2->rotation = -1.f;
-	m_physics.push_object(rigid_plane_2);
-	pbr_obj.push_back(rigid_plane_2);
-
-	Object* rigid_plane_3 = new Object(O_PLANE, glm::vec3(4.f, -10.3f, 0.5f), glm::vec3(4.f, 1.f, 4.f), P_DIMENSION); // 3
-	rigid_plane_3->rotation = 1.f;
-	m_physics.push_object(rigid_plane_3);
-	pbr_obj.push_back(rigid_plane_3);
-
-	Object* rigid_plane_4 = new Object(O_PLANE, glm::vec3(1.3f, -13.f, 0.5f), glm::vec3(4.f, 1.f, 4.f), P_DIMENSION); // 2
-	rigid_plane_4->rotation = -1.f;
-	m_physics.push_object(rigid_plane_4);
-	pbr_obj.push_back(rigid_plane_4);
-
-	Object* rigid_plane_5 = new Object(O_PLANE, glm::vec3(4.f, -16.3f, 0.5f), glm::vec3(4.f, 1.f, 4.f), P_DIMENSION); // 3
-	rigid_plane_5->rotation = 1.f;
-	m_physics.push_object(rigid_plane_5);
-	pbr_obj.push_back(rigid_plane_5);
-
-	Object* rigid_plane_6 = new Object(O_PLANE, glm::vec3(1.3f, -19.f, 0.5f), glm::vec3(4.f, 60.f, 4.f), P_DIMENSION); // 2
-	rigid_plane_6->rotation = -0.1f;
-	m_physics.push_object(rigid_plane_6);
-	pbr_obj.push_back(rigid_plane_6);
-
-	Object* rigid_plane_7 = new Object(O_PLANE, glm::vec3(8.f, -40.3f, 0.5f), glm::vec3(4.f, 40.f, 4.f), P_DIMENSION); // 3
-	rigid_plane_7->rotation = 0.1f;
-	m_physics.push_object(rigid_plane_7);
-	pbr_obj.push_back(rigid_plane_7);
-
-	//right
-	Object* rigid_cube_1 = new Object(O_PLANE, glm::vec3(4.5f, -52.f, 0.5f), glm::vec3(2.f, 2.f, 3.0f), P_DIMENSION);
-	rigid_cube_1->axis = glm::vec3(0.f, 0.f, 1.f);
-	rigid_cube_1->rotation = 1.5708f;
-	m_physics.push_object(rigid_cube_1);
-	pbr_obj.push_back(rigid_cube_1);
-
-	//left
-	Object* rigid_cube_2 = new Object(O_PLANE, glm::vec3(1.5f, -50.f, 0.5f), glm::vec3(2.f, 2.f, 3.0f), P_DIMENSION);
-	rigid_cube_2->axis = glm::vec3(0.f, 0.f, 1.f);
-	rigid_cube_2->rotation = -1.5708f;
-	m_physics.push_object(rigid_cube_2);
-	pbr_obj.push_back(rigid_cube_2);
-
-	//back
-	Object* rigid_cube_3 = new Object(O_PLANE, glm::vec3(1.5f, -50.f, 0.5f), glm::vec3(3.0f, 2.f, 2.f), P_DIMENSION);
-	rigid_cube_3->axis = glm::vec3(1.f, 0.f, 0.f);
-	rigid_cube_3->rotation = 1.5708f;
-	m_physics.push_object(rigid_cube_3);
-	pbr_obj.push_back(rigid_cube_3);
-
-	Object* rigid_plane_ = new Object(O_PLANE, glm::vec3(1.5f, -52.f, 0.5f), glm::vec3(3.0f, 3.0f, 3.0f), P_DIMENSION);
-	m_physics.push_object(rigid_plane_);
-	pbr_obj.push_back(rigid_plane_);
-
-	SoftBodyPhysics* sb_sphere = new SoftBodyPhysics(O_SPHERE, glm::vec3(6.5f, 0.f, 2.f), glm::vec3(1.f, 1.f, 1.f), MID_S_DIMENSION);
-	sb_sphere->stiffness = 0.35f;
-	sb_sphere->m_mass = 0.5f;
-	m_physics.push_object(sb_sphere);
-	softbody_obj.push_back(sb_sphere);
+	SceneContent content;
+	BuildSceneContent(0, content);
+	PushContent(content);
 
 	// camera setting
 	camera->position = glm::vec3(6.5f, 0.f, 10.f);
@@ -171,21 +106,12 @@ void Scene::Scene0Init(Camera* camera)
 	// load PBR material textures
 	for (unsigned i = 0; i < pbr_obj.size(); ++i)
 	{
-		// Fabric
-		pbr_obj[i]->albedo = albedo[2];
-		pbr_obj[i]->normal = normal[2];
-		pbr_obj[i]->metallic = metallic[2];
-		pbr_obj[i]->roughness = roughness[2];
-		pbr_obj[i]->ao = ao[2];
+		// wood
+		pbr_obj[i]->m_textype = WOOD;
 	}
 	for (unsigned i = 0; i < softbody_obj.size(); ++i)
 	{
-		// wood
-		softbody_obj[i]->albedo = albedo[4];
-		softbody_obj[i]->normal = normal[4];
-		softbody_obj[i]->metallic = metallic[4];
-		softbody_obj[i]->roughness = roughness[4];
-		softbody_obj[i]->ao = ao[4];
+		// fabric
 		softbody_obj[i]->m_textype = FABRIC;
 	}
 }
@@ -198,53 +124,25 @@ void Scene::Scene1Init(Camera* camera)
 	camera->zoom = 45.0f;
 
 	// Generate objects for scene0
-	Object* main_obj_texture = new Object(O_SPHERE, glm::vec3(1.2f,  -2.5f, 4.0f), glm::vec3(1.f, 1.f, 1.f), MID_S_DIMENSION); // mid
+	SceneContent content;
+	BuildSceneContent(1, content);
+	PushContent(content);
+
+	Object* main_obj_texture = pbr_obj[0]; // mid
 	// WOOD
-	main_obj_texture->albedo = albedo[2];
-	main_obj_texture->normal = normal[2];
-	main_obj_texture->metallic = metallic[2];
-	main_obj_texture->roughness = roughness[2];
-	main_obj_texture->ao = ao[2];
 	main_obj_texture->m_textype = WOOD;
-	m_physics.push_object(main_obj_texture);
-	pbr_obj.push_back(main_obj_texture);
 
-	Object* main_obj_texture2 = new Object(O_SPHERE, glm::vec3(1.2f, -0.5f, 2.0f), glm::vec3(1.f, 1.f, 1.f), MID_S_DIMENSION); // top
+	Object* main_obj_texture2 = pbr_obj[1]; // top
 	// STEEL
-	main_obj_texture2->albedo = albedo[1];
-	main_obj_texture2->normal = normal[1];
-	main_obj_texture2->metallic = metallic[1];
-	main_obj_texture2->roughness = roughness[1];
-	main_obj_texture2->ao = ao[1];
 	main_obj_texture2->m_textype = STEEL;
-	m_physics.push_object(main_obj_texture2);
-	pbr_obj.push_back(main_obj_texture2);
 
-	Object* main_obj_texture3 = new Object(O_SPHERE, glm::vec3(1.2f, -4.5f, 6.0f), glm::vec3(1.f, 1.f, 1.f), MID_S_DIMENSION); // bottom
+	Object* main_obj_texture3 = pbr_obj[2]; // bottom
 	// GOLD
-	main_obj_texture3->albedo = albedo[10];
-	main_obj_texture3->normal = normal[10];
-	main_obj_texture3->metallic = metallic[10];
-	main_obj_texture3->roughness = roughness[10];
-	main_obj_texture3->ao = ao[10];
 	main_obj_texture3->m_textype = GOLD;
-	m_physics.push_object(main_obj_texture3);
-	pbr_obj.push_back(main_obj_texture3);
-
-	SoftBodyPhysics* plane = new SoftBodyPhysics(O_PLANE, glm::vec3(0, 1.5f, 1.f), glm::vec3(6.f, 1.f, 10.f), P_DIMENSION);
-	plane->m_mass = 0.15f;
-	plane->stiffness = 0.8f;
-	m_physics.push_object(plane);
-	softbody_obj.push_back(plane);
 
 	for (unsigned i = 0; i < softbody_obj.size(); ++i)
 	{
-		// wood
-		softbody_obj[i]->albedo = albedo[7];
-		softbody_obj[i]->normal = normal[7];
-		softbody_obj[i]->metallic = metallic[7];
-		softbody_obj[i]->roughness = roughness[7];
-		softbody_obj[i]->ao = ao[7];
+		// copper
 		softbody_obj[i]->m_textype = COPPER;
 	}
 }
@@ -256,71 +154,23 @@ void Scene::Scene2Init(Camera* camera)
 	camera->pitch = 0.0f;
 	camera->zoom = 45.0f;
 
-	Object* rigid_plane = new Object(O_PLANE, glm::vec3(4.f, 0.5f, -2.f), glm::vec3(10.f, 10.f, 4.f), P_DIMENSION);
-	rigid_plane->rotation = 0.5f;
-	m_physics.push_object(rigid_plane);
-	pbr_obj.push_back(rigid_plane);
-
-	Object* rigid_plane_2 = new Object(O_PLANE, glm::vec3(0.f, 5.f, -10.f), glm::vec3(4.f, 10.f, 10.f), P_DIMENSION);
-	rigid_plane_2->axis = glm::vec3(1.f, 0.f, 0.f);
-	rigid_plane_2->rotation = 0.5f;
-	m_physics.push_object(rigid_plane_2);
-	pbr_obj.push_back(rigid_plane_2);
-
-	Object* rigid_plane_3 = new Object(O_PLANE, glm::vec3(-9.f, 5.f, -2.f), glm::vec3(10.f, 10.f, 4.f), P_DIMENSION);
-	rigid_plane_3->axis = glm::vec3(0.f, 0.f, -1.f);
-	rigid_plane_3->rotation = 0.5f;
-	m_physics.push_object(rigid_plane_3);
-	pbr_obj.push_back(rigid_plane_3);
-
-	Object* rigid_plane_4 = new Object(O_PLANE, glm::vec3(-13.f, -5.f, -13.f), glm::vec3(30.f, 30.f, 30.f), P_DIMENSION);
-	m_physics.push_object(rigid_plane_4);
-	pbr_obj.push_back(rigid_plane_4);
-
-	SoftBodyPhysics* sb_sphere = new SoftBodyPhysics(O_SPHERE, glm::vec3(10.f, 6.8f, 0.f), glm::vec3(1.f, 1.f, 1.f), S_DIMENSION);
-	m_physics.push_object(sb_sphere);
-	softbody_obj.push_back(sb_sphere);
-
-	SoftBodyPhysics* sb_sphere2 = new SoftBodyPhysics(O_SPHERE, glm::vec3(2.f, 7.f, -8.f), glm::vec3(1.f, 1.f, 1.f), S_DIMENSION);
-	m_physics.push_object(sb_sphere2);
-	softbody_obj.push_back(sb_sphere2);
-
-	SoftBodyPhysics* sb_sphere3 = new SoftBodyPhysics(O_SPHERE, glm::vec3(-8.f, 7.f, 0.f), glm::vec3(1.f, 1.f, 1.f), S_DIMENSION);
-	m_physics.push_object(sb_sphere3);
-	softbody_obj.push_back(sb_sphere3);
+	SceneContent content;
+	BuildSceneContent(2, content);
+	PushContent(content);
 
 	// load PBR material textures
 	for (unsigned i = 0; i < pbr_obj.size(); ++i)
 	{
 		// wood
-		pbr_obj[i]->albedo = albedo[2];
-		pbr_obj[i]->normal = normal[2];
-		pbr_obj[i]->metallic = metallic[2];
-		pbr_obj[i]->roughness = roughness[2];
-		pbr_obj[i]->ao = ao[2];
+		pbr_obj[i]->m_textype = WOOD;
 	}
 	// steel
-	softbody_obj[0]->albedo = albedo[1];
-	softbody_obj[0]->normal = normal[1];
-	softbody_obj[0]->metallic = metallic[1];
-	softbody_obj[0]->roughness = roughness[1];
-	softbody_obj[0]->ao = ao[1];
 	softbody_obj[0]->m_textype = STEEL;
 
 	// torn_fabric
-	softbody_obj[1]->albedo = albedo[5];
-	softbody_obj[1]->normal = normal[5];
-	softbody_obj[1]->metallic = metallic[5];
-	softbody_obj[1]->roughness = roughness[5];
-	softbody_obj[1]->ao = ao[5];
 	softbody_obj[1]->m_textype = TORN_FABRIC;
 
 	// rusted_iron
-	softbody_obj[2]->albedo = albedo[3];
-	softbody_obj[2]->normal = normal[3];
-	softbody_obj[2]->metallic = metallic[3];
-	softbody_obj[2]->roughness = roughness[3];
-	softbody_obj[2]->ao = ao[3];
 	softbody_obj[2]->m_textype = RUSTED_IRON;
 }
 void Scene::Scene3Init(Camera* camera)
@@ -331,63 +181,21 @@ void Scene::Scene3Init(Camera* camera)
 	camera->pitch = -19.0f;
 	camera->zoom = 45.0f;
 
-	SoftBodyPhysics* sphere[10];
-	for (int i = 0; i < 10; ++i)
+	SceneContent content;
+	BuildSceneContent(3, content);
+	PushContent(content);
+
+	for (unsigned i = 0; i < softbody_obj.size(); ++i)
 	{
-		sphere[i] = new SoftBodyPhysics(O_SPHERE, glm::vec3(3.f, 3.f+(float)i*5.f, 2.f), glm::vec3(1.f, 1.f, 1.f), S_DIMENSION);
-		sphere[i]->stiffness = 0.35f;
-		// steel
-		sphere[i]->albedo = albedo[8];
-		sphere[i]->normal = normal[8];
-		sphere[i]->metallic = metallic[8];
-		sphere[i]->roughness = roughness[8];
-		sphere[i]->ao = ao[8];
-		sphere[i]->m_textype = CONCRETE;
-		m_physics.push_object(sphere[i]);
-		softbody_obj.push_back(sphere[i]);
+		// concrete
+		softbody_obj[i]->m_textype = CONCRETE;
 	}
 
-	//front
-	Object* rigid_cube_0 = new Object(O_PLANE, glm::vec3(0.f, -10.f, 7.f), glm::vec3(7.f, 2.f, 2.f), P_DIMENSION);
-	rigid_cube_0->axis = glm::vec3(1.f, 0.f, 0.f); 
-	rigid_cube_0->rotation = -1.5708f;
-	m_physics.push_object(rigid_cube_0);
-	pbr_obj.push_back(rigid_cube_0);
-
-	//right
-	Object* rigid_cube_1 = new Object(O_PLANE, glm::vec3(7.f, -10.f, 0.f), glm::vec3(2.f, 2.f, 7.f), P_DIMENSION);
-	rigid_cube_1->axis = glm::vec3(0.f, 0.f, 1.f);
-	rigid_cube_1->rotation = 1.5708f;
-	m_physics.push_object(rigid_cube_1);
-	pbr_obj.push_back(rigid_cube_1);
-
-	//left
-	Object* rigid_cube_2 = new Object(O_PLANE, glm::vec3(0.f, -8.f, 0.f), glm::vec3(2.f, 2.f, 7.f), P_DIMENSION);
-	rigid_cube_2->axis = glm::vec3(0.f, 0.f, 1.f);
-	rigid_cube_2->rotation = -1.5708f;
-	m_physics.push_object(rigid_cube_2);
-	pbr_obj.push_back(rigid_cube_2);
-
-	//back
-	Object* rigid_cube_3 = new Object(O_PLANE, glm::vec3(0.f, -8.f, 0.f), glm::vec3(7.f, 2.f, 2.f), P_DIMENSION);
-	rigid_cube_3->axis = glm::vec3(1.f, 0.f, 0.f);
-	rigid_cube_3->rotation = 1.5708f;
-	m_physics.push_object(rigid_cube_3);
-	pbr_obj.push_back(rigid_cube_3);
-
-	Object* rigid_plane = new Object(O_PLANE, glm::vec3(0.f, -10.f, 0.f), glm::vec3(7.f, 7.f, 7.f), P_DIMENSION);
-	m_physics.push_object(rigid_plane);
-	pbr_obj.push_back(rigid_plane);
-
 	// load PBR material textures
 	for (unsigned i = 0; i < pbr_obj.size(); ++i)
 	{
 		// wood
-		pbr_obj[i]->albedo = albedo[2];
-		pbr_obj[i]->normal = normal[2];
-		pbr_obj[i]->metallic = metallic[2];
-		pbr_obj[i]->roughness = roughness[2];
-		pbr_obj[i]->ao = ao[2];
+		pbr_obj[i]->m_textype = WOOD;
 	}
 }
 void Scene::Scene4Init(Camera* camera)
@@ -400,11 +208,7 @@ void Scene::Scene4Init(Camera* camera)
 
 	glm::vec3 obj_pos = glm::vec3(0.f, 0.f, 0.f);
 	Object* pbr_sphere = new Object(O_SPHERE, obj_pos, glm::vec3(1.f, 1.f, 1.f), P_DIMENSION);
-	pbr_sphere->albedo = albedo[0];
-	pbr_sphere->normal = normal[0];
-	pbr_sphere->metallic = metallic[0];
-	pbr_sphere->roughness = roughness[0];
-	pbr_sphere->ao = ao[0];
+	pbr_sphere->m_textype = PLASTIC;
 	pbr_obj.push_back(pbr_sphere);
 
 	Light m_light;
@@ -435,24 +239,10 @@ void Scene::Scene5Init(Camera* camera)
 		for (int y = -Y_SEGMENT + 2; y < Y_SEGMENT; y += 2)
 		{
 			temp_coord.y = static_cast<float>(y);
-			int rand_texture = rand() % 11;
-			Object* pbr_back = new Object(O_SPHERE, temp_coord, glm::vec3(1.f, 1.f, 1.f), MID_S_DIMENSION); // (-10, -10, -10) ~ (-10, -10, -10)
-			pbr_back->albedo = albedo[rand_texture];
-			pbr_back->normal = normal[rand_texture];
-			pbr_back->metallic = metallic[rand_texture];
-			pbr_back->roughness = roughness[rand_texture];
-			pbr_back->ao = ao[rand_texture];
-			pbr_obj.push_back(pbr_back);
+			AddPBRSphere(temp_coord);
 
 			temp_coord.z += (Z_SEGMENT) * 2;
-			rand_texture = rand() % 11;
-			Object* pbr_front = new Object(O_SPHERE, temp_coord, glm::vec3(1.f, 1.f, 1.f), MID_S_DIMENSION); // (10, -10, 10) ~ (10, -10, 10)
-			pbr_front->albedo = albedo[rand_texture];
-			pbr_front->normal = normal[rand_texture];
-			pbr_front->metallic = metallic[rand_texture];
-			pbr_front->roughness = roughness[rand_texture];
-			pbr_front->ao = ao[rand_texture];
-			pbr_obj.push_back(pbr_front);
+			AddPBRSphere(temp_coord);
 
 			temp_coord.z = static_cast<float>(-Z_SEGMENT);
 		}
@@ -464,24 +254,10 @@ void Scene::Scene5Init(Camera* camera)
 		for (int z = -Z_SEGMENT + 2; z < Z_SEGMENT; z += 2)
 		{
 			temp_coord.z = static_cast<float>(z);
-			int rand_texture = rand() % 11;
-			Object* pbr_back = new Object(O_SPHERE, temp_coord, glm::vec3(1.f, 1.f, 1.f), MID_S_DIMENSION); // (-10, -10, -10) ~ (-10, -10, -10)
-			pbr_back->albedo = albedo[rand_texture];
-			pbr_back->normal = normal[rand_texture];
-			pbr_back->metallic = metallic[rand_texture];
-			pbr_back->roughness = roughness[rand_texture];
-			pbr_back->ao = ao[rand_texture];
-			pbr_obj.push_back(pbr_back);
+			AddPBRSphere(temp_coord);
 
 			temp_coord.x += (X_SEGMENT) * 2;
-			rand_texture = rand() % 11;
-			Object* pbr_front = new Object(O_SPHERE, temp_coord, glm::vec3(1.f, 1.f, 1.f), MID_S_DIMENSION); // (10, 10, -10) ~ (10, 10, -10)
-			pbr_front->albedo = albedo[rand_texture];
-			pbr_front->normal = normal[rand_texture];
-			pbr_front->metallic = metallic[rand_texture];
-			pbr_front->roughness = roughness[rand_texture];
-			pbr_front->ao = ao[rand_texture];
-			pbr_obj.push_back(pbr_front);
+			AddPBRSphere(temp_coord);
 
 			temp_coord.x = static_cast<float>(-X_SEGMENT);
 		}
@@ -493,24 +269,10 @@ void Scene::Scene5Init(Camera* camera)
 		for (int z = -Z_SEGMENT + 2; z < Z_SEGMENT; z += 2)
 		{
 			temp_coord.z = static_cast<float>(z);
-			int rand_texture = rand() % 11;
-			Object* pbr_back = new Object(O_SPHERE, temp_coord, glm::vec3(1.f, 1.f, 1.f), MID_S_DIMENSION); // (-10, -10, -10) ~ (-10, -10, -10)
-			pbr_back->albedo = albedo[rand_texture];
-			pbr_back->normal = normal[rand_texture];
-			pbr_back->metallic = metallic[rand_texture];
-			pbr_back->roughness = roughness[rand_texture];
-			pbr_back->ao = ao[rand_texture];
-			pbr_obj.push_back(pbr_back);
+			AddPBRSphere(temp_coord);
 
 			temp_coord.y += (Y_SEGMENT) * 2;
-			rand_texture = rand() % 11;
-			Object* pbr_front = new Object(O_SPHERE, temp_coord, glm::vec3(1.f, 1.f, 1.f), MID_S_DIMENSION); // (-10, 10, 10) ~ (-10, 10, 10)
-			pbr_front->albedo = albedo[rand_texture];
-			pbr_front->normal = normal[rand_texture];
-			pbr_front->metallic = metallic[rand_texture];
-			pbr_front->roughness = roughness[rand_texture];
-			pbr_front->ao = ao[rand_texture];
-			pbr_obj.push_back(pbr_front);
+			AddPBRSphere(temp_coord);
 
 			temp_coord.y = static_cast<float>(-Y_SEGMENT);
 		}
@@ -523,24 +285,10 @@ void Scene::Scene5Init(Camera* camera)
 		for (int y = -Y_SEGMENT + 2; y < Y_SEGMENT; y += 2)
 		{
 			temp_coord.y = static_cast<float>(y);
-			int rand_texture = rand() % 11;
-			Object* pbr_back = new Object(O_SPHERE, temp_coord, glm::vec3(1.f, 1.f, 1.f), MID_S_DIMENSION); // (-10, -10, -10) ~ (10, -10, -10)
-			pbr_back->albedo = albedo[rand_texture];
-			pbr_back->normal = normal[rand_texture];
-			pbr_back->metallic = metallic[rand_texture];
-			pbr_back->roughness = roughness[rand_texture];
-			pbr_back->ao = ao[rand_texture];
-			pbr_obj.push_back(pbr_back);
+			AddPBRSphere(temp_coord);
 
 			temp_coord.z += (Z_SEGMENT) * 2;
-			rand_texture = rand() % 11;
-			Object* pbr_front = new Object(O_SPHERE, temp_coord, glm::vec3(1.f, 1.f, 1.f), MID_S_DIMENSION); // (-10, -10, -10) ~ (10, -10, -10)
-			pbr_front->albedo = albedo[rand_texture];
-			pbr_front->normal = normal[rand_texture];
-			pbr_front->metallic = metallic[rand_texture];
-			pbr_front->roughness = roughness[rand_texture];
-			pbr_front->ao = ao[rand_texture];
-			pbr_obj.push_back(pbr_front);
+			AddPBRSphere(temp_coord);
 
 			temp_coord.z = static_cast<float>(-Z_SEGMENT);
 		}
@@ -552,24 +300,10 @@ void Scene::Scene5Init(Camera* camera)
 		for (int z = -Z_SEGMENT + 2; z < Z_SEGMENT; z += 2)
 		{
 			temp_coord.z = static_cast<float>(z);
-			int rand_texture = rand() % 11;
-			Object* pbr_back = new Object(O_SPHERE, temp_coord, glm::vec3(1.f, 1.f, 1.f), MID_S_DIMENSION); // (-10, -10, -10) ~ (10, -10, -10)
-			pbr_back->albedo = albedo[rand_texture];
-			pbr_back->normal = normal[rand_texture];
-			pbr_back->metallic = metallic[rand_texture];
-			pbr_back->roughness = roughness[rand_texture];
-			pbr_back->ao = ao[rand_texture];
-			pbr_obj.push_back(pbr_back);
+			AddPBRSphere(temp_coord);
 
 			temp_coord.x += (X_SEGMENT) * 2;
-			rand_texture = rand() % 11;
-			Object* pbr_front = new Object(O_SPHERE, temp_coord, glm::vec3(1.f, 1.f, 1.f), MID_S_DIMENSION); // (-10, -10, -10) ~ (10, -10, -10)
-			pbr_front->albedo = albedo[rand_texture];
-			pbr_front->normal = normal[rand_texture];
-			pbr_front->metallic = metallic[rand_texture];
-			pbr_front->roughness = roughness[rand_texture];
-			pbr_front->ao = ao[rand_texture];
-			pbr_obj.push_back(pbr_front);
+			AddPBRSphere(temp_coord);
 
 			temp_coord.x = static_cast<float>(-X_SEGMENT);
 		}
@@ -581,24 +315,10 @@ void Scene::Scene5Init(Camera* camera)
 		for (int z = -Z_SEGMENT + 2; z < Z_SEGMENT; z += 2)
 		{
 			temp_coord.z = static_cast<float>(z);
-			int rand_texture = rand() % 11;
-			Object* pbr_back = new Object(O_SPHERE, temp_coord, glm::vec3(1.f, 1.f, 1.f), MID_S_DIMENSION); // (-10, -10, -10) ~ (10, -10, -10)
-			pbr_back->albedo = albedo[rand_texture];
-			pbr_back->normal = normal[rand_texture];
-			pbr_back->metallic = metallic[rand_texture];
-			pbr_back->roughness = roughness[rand_texture];
-			pbr_back->ao = ao[rand_texture];
-			pbr_obj.push_back(pbr_back);
+			AddPBRSphere(temp_coord);
 
 			temp_coord.y += (Y_SEGMENT) * 2;
-			rand_texture = rand() % 11;
-			Object* pbr_front = new Object(O_SPHERE, temp_coord, glm::vec3(1.f, 1.f, 1.f), MID_S_DIMENSION); // (-10, -10, -10) ~ (10, -10, -10)
-			pbr_front->albedo = albedo[rand_texture];
-			pbr_front->normal = normal[rand_texture];
-			pbr_front->metallic = metallic[rand_texture];
-			pbr_front->roughness = roughness[rand_texture];
-			pbr_front->ao = ao[rand_texture];
-			pbr_obj.push_back(pbr_front);
+			AddPBRSphere(temp_coord);
 
 			temp_coord.y = static_cast<float>(-Y_SEGMENT);
 		}
@@ -629,17 +349,20 @@ void Scene::Scene5Init(Camera* camera)
 	}
 	magnitude = 3.5f;
 }
+void Scene::AddPBRSphere(glm::vec3 position)
+{
+	int rand_texture = rand() % MATERIAL_COUNT;
+	sphere_instances.Add(O_SPHERE, MID_S_DIMENSION, glm::translate(glm::mat4(1.f), position), glm::vec4(0.f, 0.f, static_cast<float>(rand_texture), 0.f));
+}
 
 void Scene::Scene0Draw(GLFWwindow* window, Camera* camera, float dt)
 {
-	if (dt <= FRAME_LIMIT && move_object)
+	if (move_object && !softbody_obj.empty())
 	{
-		if (!softbody_obj.empty())
-		{
-			m_physics.update(dt);
-			for (std::vector<SoftBodyPhysics*>::iterator obj = softbody_obj.begin(); obj != softbody_obj.end(); ++obj)
-				(*obj)->Describe();
-		}
+		m_physics.step(dt);
+		for (std::vector<SoftBodyPhysics*>::iterator obj = softbody_obj.begin(); obj != softbody_obj.end(); ++obj)
+			if (!(*obj)->on_gpu())
+				(*obj)->Stream();
 	}
 
 	glClearColor(0.2f, 0.2f, 0.2f, 1.0f);
@@ -648,7 +371,7 @@ void Scene::Scene0Draw(GLFWwindow* window, Camera* camera, float dt)
 	camera->position = softbody_obj[0]->position + glm::vec3(0.f,0.f,8.f);
 	pbr_texture_shader.Use();
 	camera->Update(&pbr_texture_shader);
-	pbr_texture_shader.SetVec3("camPos", camera->position);
+	uniform_blocks.UpdateFrame(camera, aspect);
 
 	// Draw objs
 	DrawObjs(camera, curr_scene);
@@ -657,31 +380,26 @@ void Scene::Scene0Draw(GLFWwindow* window, Camera* camera, float dt)
 	glBindTexture(GL_TEXTURE_CUBE_MAP, envCubemap);
 
 	// main object metallic, roughness
-	pbr_texture_shader.SetFloat("roughness_val", rou);
-	pbr_texture_shader.SetBool("roughness_status", roughness_status);
-	pbr_texture_shader.SetBool("metallic_status", metallic_status);
-	pbr_texture_shader.SetFloat("metallic_val", met);
+	uniform_blocks.UpdateMaterial(met, rou, metallic_status, roughness_status);
 
 	// render skybox (render as last to prevent overdraw)
-	renderSkybox(&backgroundShader, camera, envCubemap, irradianceMap);
+	renderSkybox(&backgroundShader, envCubemap, irradianceMap);
 }
 void Scene::Scene1Draw(Camera* camera, float dt)
 {
-	if (dt <= FRAME_LIMIT && move_object)
+	if (move_object && !softbody_obj.empty())
 	{
-		if (!softbody_obj.empty())
-		{
-			m_physics.update(dt);
-			for (std::vector<SoftBodyPhysics*>::iterator obj = softbody_obj.begin(); obj != softbody_obj.end(); ++obj)
-				(*obj)->Describe();
-		}
+		m_physics.step(dt);
+		for (std::vector<SoftBodyPhysics*>::iterator obj = softbody_obj.begin(); obj != softbody_obj.end(); ++obj)
+			if (!(*obj)->on_gpu())
+				(*obj)->Stream();
 	}
 	glClearColor(0.2f, 0.2f, 0.2f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 	pbr_texture_shader.Use();
 	camera->Update(&pbr_texture_shader);
-	pbr_texture_shader.SetVec3("camPos", camera->position);
+	uniform_blocks.UpdateFrame(camera, aspect);
 
 	// Draw objs
 	DrawObjs(camera, curr_scene);
@@ -693,33 +411,28 @@ void Scene::Scene1Draw(Camera* camera, float dt)
 	glBindTexture(GL_TEXTURE_CUBE_MAP, envCubemap);
 
 	// main object metallic, roughness
-	pbr_texture_shader.SetFloat("roughness_val", rou);
-	pbr_texture_shader.SetBool("roughness_status", roughness_status);
-	pbr_texture_shader.SetBool("metallic_status", metallic_status);
-	pbr_texture_shader.SetFloat("metallic_val", met);
+	uniform_blocks.UpdateMaterial(met, rou, metallic_status, roughness_status);
 
 	// render skybox (render as last to prevent overdraw)
-	renderSkybox(&backgroundShader, camera, envCubemap, irradianceMap);
+	renderSkybox(&backgroundShader, envCubemap, irradianceMap);
 }
 
 void Scene::Scene2Draw(Camera* camera, float dt)
 {
 
-	if (dt <= FRAME_LIMIT && move_object)
+	if (move_object && !softbody_obj.empty())
 	{
-		if (!softbody_obj.empty())
-		{
-			m_physics.update(dt);
-			for (std::vector<SoftBodyPhysics*>::iterator obj = softbody_obj.begin(); obj != softbody_obj.end(); ++obj)
-				(*obj)->Describe();
-		}
+		m_physics.step(dt);
+		for (std::vector<SoftBodyPhysics*>::iterator obj = softbody_obj.begin(); obj != softbody_obj.end(); ++obj)
+			if (!(*obj)->on_gpu())
+				(*obj)->Stream();
 	}
 	glClearColor(0.2f, 0.2f, 0.2f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 	pbr_texture_shader.Use();
 	camera->Update(&pbr_texture_shader);
-	pbr_texture_shader.SetVec3("camPos", camera->position);
+	uniform_blocks.UpdateFrame(camera, aspect);
 
 	// Draw objs
 	DrawObjs(camera, curr_scene);
@@ -731,13 +444,10 @@ void Scene::Scene2Draw(Camera* camera, float dt)
 	glBindTexture(GL_TEXTURE_CUBE_MAP, envCubemap);
 
 	// main object metallic, roughness
-	pbr_texture_shader.SetFloat("roughness_val", rou);
-	pbr_texture_shader.SetBool("roughness_status", roughness_status);
-	pbr_texture_shader.SetBool("metallic_status", metallic_status);
-	pbr_texture_shader.SetFloat("metallic_val", met);
+	uniform_blocks.UpdateMaterial(met, rou, metallic_status, roughness_status);
 
 	// render skybox (render as last to prevent overdraw)
-	renderSkybox(&backgroundShader, camera, envCubemap, irradianceMap);
+	renderSkybox(&backgroundShader, envCubemap, irradianceMap);
 }
 void Scene::Scene3Draw(Camera* camera, float dt)
 {
@@ -751,14 +461,13 @@ void Scene::Scene4Draw(Camera* camera, float dt)
 
 	pbr_texture_shader.Use();
 	camera->Update(&pbr_texture_shader);
-	pbr_texture_shader.SetVec3("camPos", camera->position);
+	uniform_blocks.UpdateFrame(camera, aspect);
 
 	// Draw objs
 	DrawObjs(camera, curr_scene);
 	// update Lighting
 	light_obj[0]->color = light[0].color * 300.f;
-	pbr_texture_shader.SetVec3("lightPositions[" + std::to_string(0) + "]", light_obj[0]->position);
-	pbr_texture_shader.SetVec3("lightColors[" + std::to_string(0) + "]", light_obj[0]->color);
+	UploadLights();
 
 	lightShader.Use();
 	light_obj[0]->position.x = sinf(angle) * 3.f;
@@ -768,20 +477,17 @@ void Scene::Scene4Draw(Camera* camera, float dt)
 	angle += dt;
 	lightShader.SetVec3("lightPosition", light[0].position);
 	lightShader.SetVec3("lightColor", light[0].color);
-	light_obj[0]->render_lights(camera, &lightShader, light_obj[0]->position, aspect);
+	light_obj[0]->render_lights(&lightShader, light_obj[0]->position);
 	
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_CUBE_MAP, envCubemap);
 
 	pbr_texture_shader.Use();
 	// main object metallic, roughness
-	pbr_texture_shader.SetFloat("roughness_val", rou);
-	pbr_texture_shader.SetBool("roughness_status", roughness_status);
-	pbr_texture_shader.SetBool("metallic_status", metallic_status);
-	pbr_texture_shader.SetFloat("metallic_val", met);
+	uniform_blocks.UpdateMaterial(met, rou, metallic_status, roughness_status);
 	
 	// render skybox (render as last to prevent overdraw)
-	renderSkybox(&backgroundShader, camera, envCubemap, irradianceMap);
+	renderSkybox(&backgroundShader, envCubemap, irradianceMap);
 }
 void Scene::Scene5Draw(Camera* camera, float dt)
 {
@@ -790,20 +496,18 @@ void Scene::Scene5Draw(Camera* camera, float dt)
 
 	pbr_texture_shader.Use();
 	camera->Update(&pbr_texture_shader);
-	pbr_texture_shader.SetVec3("camPos", camera->position);
+	uniform_blocks.UpdateFrame(camera, aspect);
 
 	// Draw objs
 	DrawObjs(camera, curr_scene);
 
 	// lighting
 	for (unsigned int i = 0; i < light_num; ++i)
-	{
-		light_obj[i]->color = light[i].color * 300.f;
-		pbr_texture_shader.SetVec3("lightPositions[" + std::to_string(i) + "]", light_obj[i]->position);
-		pbr_texture_shader.SetVec3("lightColors[" + std::to_string(i) + "]", light_obj[i]->color); // 300, 300, 300
-	}
+		light_obj[i]->color = light[i].color * 300.f; // 300, 300, 300
+	UploadLights();
 	// lighting
 	lightShader.Use();
+	light_instances.ClearInstances();
 	glm::vec3 prev = light_obj[cam_num]->position;
 	for (unsigned int i = 1; i < light_num; ++i)
 	{
@@ -812,13 +516,13 @@ void Scene::Scene5Draw(Camera* camera, float dt)
 		light_obj[i]->position.z = (4 + sin(i * PI / 25 * angle * 3)) * sin(PI / (10 + i) * (2 + sin(2 * PI / 35 * angle * 3))) * sin(i * PI * (1 + sin(2 * PI / 35 * angle * 3))) * magnitude;
 
 		angle += (orbit_speed / light_num);
-		lightShader.SetVec3("lightPosition", light[i].position);
-		lightShader.SetVec3("lightColor", light[i].color);
 		light[i].position = light_obj[i]->position;
 
 		if (i != cam_num)
-			light_obj[i]->render_lights(camera, &lightShader, light_obj[i]->position, aspect);
+			light_instances.Add(O_SPHERE, light_obj[i]->dimension, glm::scale(glm::translate(glm::mat4(1.f), light_obj[i]->position), light_obj[i]->scale),
+				glm::vec4(light[i].color, 1.f));
 	}
+	light_instances.Draw(&lightShader, GL_TRIANGLES);
 
 	if (cam_move)
 	{
@@ -834,11 +538,10 @@ void Scene::Scene5Draw(Camera* camera, float dt)
 	glBindTexture(GL_TEXTURE_CUBE_MAP, envCubemap);
 
 	// main object metallic, roughness
-	pbr_texture_shader.SetBool("roughness_status", true);
-	pbr_texture_shader.SetBool("metallic_status", true);
+	uniform_blocks.UpdateMaterial(met, rou, true, true);
 
 	// render skybox (render as last to prevent overdraw)
-	renderSkybox(&backgroundShader, camera, envCubemap, irradianceMap);
+	renderSkybox(&backgroundShader, envCubemap, irradianceMap);
 }
 void Scene::DrawObjs(Camera* camera, unsigned scene_num)
 {
@@ -850,65 +553,44 @@ void Scene::DrawObjs(Camera* camera, unsigned scene_num)
 	glActiveTexture(GL_TEXTURE2);
 	glBindTexture(GL_TEXTURE_2D, brdfLUTTexture);
 
-	for (auto obj : pbr_obj)
-	{
-		glActiveTexture(GL_TEXTURE3);
-		glBindTexture(GL_TEXTURE_2D, (*obj).albedo);
-		glActiveTexture(GL_TEXTURE4);
-		glBindTexture(GL_TEXTURE_2D, (*obj).normal);
-		glActiveTexture(GL_TEXTURE5);
-		glBindTexture(GL_TEXTURE_2D, (*obj).metallic);
-		glActiveTexture(GL_TEXTURE6);
-		glBindTexture(GL_TEXTURE_2D, (*obj).roughness);
-		glActiveTexture(GL_TEXTURE7);
-		glBindTexture(GL_TEXTURE_2D, (*obj). ao);
-	}
-	for (std::vector<Object*>::iterator p_obj = pbr_obj.begin(); p_obj != pbr_obj.end(); ++p_obj)
-	{
-		pbr_texture_shader.SetInt("albedoMap", (*p_obj)->albedo + 2);
-		pbr_texture_shader.SetInt("normalMap", (*p_obj)->normal + 2);
-		pbr_texture_shader.SetInt("metallicMap", (*p_obj)->metallic + 2);
-		pbr_texture_shader.SetInt("roughnessMap", (*p_obj)->roughness + 2);
-		pbr_texture_shader.SetInt("aoMap", (*p_obj)->ao + 2);
-		(*p_obj)->render_objs(camera, &pbr_texture_shader, (*p_obj)->position, aspect, false);
-	}
-	for(unsigned i = 0; i < softbody_obj.size(); ++i)
+	materials.Bind();
+
+	// every material is a layer of the same arrays, sorted so the layer only changes between runs
+	draw_order.clear();
+	for (Object* obj : pbr_obj)
+		draw_order.push_back(std::make_pair(obj, false));
+	for (SoftBodyPhysics* obj : softbody_obj)
+		draw_order.push_back(std::make_pair(static_cast<Object*>(obj), draw_line));
+	std::stable_sort(draw_order.begin(), draw_order.end(),
+		[](const std::pair<Object*, bool>& a, const std::pair<Object*, bool>& b) { return a.first->m_textype < b.first->m_textype; });
+	int material = -1;
+	for (const std::pair<Object*, bool>& draw : draw_order)
 	{
-		int buff_offset = ChangePBRTexture(softbody_obj[i]->m_textype, i, true);
-		glActiveTexture(GL_TEXTURE3 + buff_offset);
-		glBindTexture(GL_TEXTURE_2D, softbody_obj[i]->albedo);
-		glActiveTexture(GL_TEXTURE4 + buff_offset);
-		glBindTexture(GL_TEXTURE_2D, softbody_obj[i]->normal);
-		glActiveTexture(GL_TEXTURE5 + buff_offset);
-		glBindTexture(GL_TEXTURE_2D, softbody_obj[i]->metallic);
-		glActiveTexture(GL_TEXTURE6 + buff_offset);
-		glBindTexture(GL_TEXTURE_2D, softbody_obj[i]->roughness);
-		glActiveTexture(GL_TEXTURE7 + buff_offset);
-		glBindTexture(GL_TEXTURE_2D, softbody_obj[i]->ao);
+		if (draw.first->m_textype != material)
+		{
+			material = draw.first->m_textype;
+			pbr_texture_shader.SetInt(pbr_texture_shader.Common().material, material);
+		}
+		draw.first->render_objs(&pbr_texture_shader, draw.first->position, draw.second);
 	}
-	for (std::vector<SoftBodyPhysics*>::iterator s_obj = softbody_obj.begin(); s_obj != softbody_obj.end(); ++s_obj)
+	sphere_instances.Draw(&pbr_texture_shader, GL_TRIANGLE_STRIP);
+}
+void Scene::UploadLights()
+{
+	glm::vec3 positions[light_num], colors[light_num];
+	unsigned count = std::min(static_cast<unsigned>(light_obj.size()), light_num);
+	for (unsigned i = 0; i < count; ++i)
 	{
-		pbr_texture_shader.SetInt("albedoMap", (*s_obj)->albedo + 2);
-		pbr_texture_shader.SetInt("normalMap", (*s_obj)->normal + 2);
-		pbr_texture_shader.SetInt("metallicMap", (*s_obj)->metallic + 2);
-		pbr_texture_shader.SetInt("roughnessMap", (*s_obj)->roughness + 2);
-		pbr_texture_shader.SetInt("aoMap", (*s_obj)->ao + 2);
-		(*s_obj)->render_objs(camera, &pbr_texture_shader, (*s_obj)->position, aspect, draw_line);
+		positions[i] = light_obj[i]->position;
+		colors[i] = light_obj[i]->color;
 	}
-	pbr_texture_shader.SetInt("light_num", static_cast<int>(light_obj.size()));
+	uniform_blocks.UpdateLights(positions, colors, static_cast<int>(count));
 }
 void Scene::DeletePBRTextures()
 {
-	for (unsigned i = 0; i < pbr_number; ++i)
-	{
-		glDeleteTextures(1, &albedo[i]);
-		glDeleteTextures(1, &normal[i]);
-		glDeleteTextures(1, &roughness[i]);
-		glDeleteTextures(1, &metallic[i]);
-		glDeleteTextures(1, &ao[i]);
-	}
+	materials.Delete();
 }
-void Scene::ImGuiUpdate(GLFWwindow* window, Camera* camera, float dt)
+void Scene::ImGuiUpdate(Camera* camera, float dt)
 {
 	ImGui_ImplOpenGL3_NewFrame();
 	ImGui_ImplGlfw_NewFrame();
@@ -918,6 +600,14 @@ void Scene::ImGuiUpdate(GLFWwindow* window, Camera* camera, float dt)
 
 	ImGui::Begin("GUI interface");
 	ImGui::Text("Frame Per Second : %d ms", static_cast<int>(1.f / dt));
+	bool fast_physics = m_physics.get_step() < PHYSICS_STEP;
+	if (ImGui::Checkbox("120 Hz physics", &fast_physics))
+		m_physics.set_step(fast_physics ? PHYSICS_STEP * 0.5f : PHYSICS_STEP);
+	bool gpu_softbody = !softbody_obj.empty() && softbody_obj[0]->on_gpu();
+	if (!m_physics.gpu_allowed())
+		ImGui::Text("GPU softbodies: single softbody scenes only");
+	else if (ImGui::Checkbox("GPU softbodies", &gpu_softbody))
+		m_physics.UseGpu(gpu_softbody);
 	ImGui::End();
 
 	if (second_imgui)
@@ -926,65 +616,17 @@ void Scene::ImGuiUpdate(GLFWwindow* window, Camera* camera, float dt)
 		if (ImGui::Button("Reload"))
 			Reload(camera);
 		if (ImGui::Button("Scene0"))
-		{
-			if (curr_scene != 0)
-			{
-				ShutDown();
-				m_physics.clear_objects();
-				curr_scene = 0;
-				Init(window, camera);
-			}
-		}
+			ChangeScene(0, camera);
 		if (ImGui::Button("Scene1"))
-		{
-			if (curr_scene != 1)
-			{
-				ShutDown();
-				m_physics.clear_objects();
-				curr_scene = 1;
-				Init(window, camera);
-			}
-		}
+			ChangeScene(1, camera);
 		if (ImGui::Button("Scene2"))
-		{
-			if (curr_scene != 2)
-			{
-				ShutDown();
-				m_physics.clear_objects();
-				curr_scene = 2;
-				Init(window, camera);
-			}
-		}
+			ChangeScene(2, camera);
 		if (ImGui::Button("Scene3"))
-		{
-			if (curr_scene != 3)
-			{
-				ShutDown();
-				m_physics.clear_objects();
-				curr_scene = 3;
-				Init(window, camera);
-			}
-		}
+			ChangeScene(3, camera);
 		if (ImGui::Button("Scene4"))
-		{
-			if (curr_scene != 4)
-			{
-				ShutDown();
-				// no physics obj
-				curr_scene = 4;
-				Init(window, camera);
-			}
-		}
+			ChangeScene(4, camera);
 		if (ImGui::Button("Scene5"))
-		{
-			if (curr_scene != 5)
-			{
-				ShutDown();
-				// no physics obj
-				curr_scene = 5;
-				Init(window, camera);
-			}
-		}
+			ChangeScene(5, camera);
 		ImGui::End();
 	}
 	if (third_imgui)
@@ -1160,6 +802,17 @@ void Scene::ImGuiShutdown()
 void Scene::Reload(Camera* camera)
 {
 	ShutDown();
+	InitContent(camera);
+}
+void Scene::ChangeScene(unsigned scene, Camera* camera)
+{
+	if (curr_scene == scene)
+		return;
+	curr_scene = scene;
+	Reload(camera);
+}
+void Scene::InitContent(Camera* camera)
+{
 	if (curr_scene == 0)
 		Scene0Init(camera);
 	else if (curr_scene == 1)
@@ -1199,29 +852,24 @@ void Scene::ShutDown()
 	}
 	if (!light_obj.empty())
 		light_obj.clear();
+	sphere_instances.Clear();
+	light_instances.Clear();
+	// scenes without lights draw with none, not the last scene's
+	uniform_blocks.UpdateLights(nullptr, nullptr, 0);
 }
 void Scene::DeleteBuffers()
 {
+	uniform_blocks.Shutdown();
 	if (captureFBO)
 		glDeleteFramebuffers(1, &captureFBO);
 	if (captureRBO)
 		glDeleteRenderbuffers(1, &captureRBO);
-	if (envCubemap)
-		glDeleteTextures(1, &envCubemap);
-	if (irradianceMap)
-		glDeleteTextures(1, &irradianceMap);
-	if (prefilterMap)
-		glDeleteTextures(1, &prefilterMap);
-	if (brdfLUTTexture)
-		glDeleteTextures(1, &brdfLUTTexture);
-	for (unsigned i = 0; i < pbr_number; ++i)
-	{
-		glDeleteTextures(1, &albedo[i]);
-		glDeleteTextures(1, &normal[i]);
-		glDeleteTextures(1, &metallic[i]);
-		glDeleteTextures(1, &roughness[i]);
-		glDeleteTextures(1, &ao[i]);
-	}
+	// glDeleteTextures skips the 0 of a map that was never made, hdrTexture stays 0 when the IBL cache hit
+	unsigned textures[] = { envCubemap, irradianceMap, prefilterMap, brdfLUTTexture, hdrTexture };
+	glDeleteTextures(5, textures);
+	captureFBO = captureRBO = 0;
+	envCubemap = irradianceMap = prefilterMap = brdfLUTTexture = hdrTexture = 0;
+	DeletePBRTextures();
 }
 void Scene::ResizeFrameBuffer(GLFWwindow* window)
 {
@@ -1232,437 +880,22 @@ void Scene::ResizeFrameBuffer(GLFWwindow* window)
 }
 void Scene::InitAllPBRTexture()
 {
-	Object* rigid_plane = new Object(O_PLANE, glm::vec3(0.f, 0.f, 0.f), glm::vec3(0.f, 0.f, 0.f), dimension_);
-
-	// plastic
-	albedo[0] = rigid_plane->loadTexture("models\\pbr\\plastic\\Sphere3D_1_defaultMat_BaseColor.png");
-	normal[0] = rigid_plane->loadTexture("models\\pbr\\plastic\\Sphere3D_1_defaultMat_Normal.png");
-	metallic[0] = rigid_plane->loadTexture("models\\pbr\\plastic\\Sphere3D_1_defaultMat_Metallic.png");
-	roughness[0] = rigid_plane->loadTexture("models\\pbr\\plastic\\Sphere3D_1_defaultMat_Roughness.png");
-	ao[0] = rigid_plane->loadTexture("models\\pbr\\plastic\\ao.png");
-
-	// steel
-	albedo[1] = rigid_plane->loadTexture("models\\pbr\\steel\\Sphere3D_1_defaultMat_BaseColor.png");
-	normal[1] = rigid_plane->loadTexture("models\\pbr\\steel\\Sphere3D_1_defaultMat_Normal.png");
-	metallic[1] = rigid_plane->loadTexture("models\\pbr\\steel\\Sphere3D_1_defaultMat_Metallic.png");
-	roughness[1] = rigid_plane->loadTexture("models\\pbr\\steel\\Sphere3D_1_defaultMat_Roughness.png");
-	ao[1] = rigid_plane->loadTexture("models\\pbr\\steel\\ao.png");
-
-	// wood
-	albedo[2] = rigid_plane->loadTexture("models\\pbr\\Wood\\Sphere3D_1_defaultMat_BaseColor.png");
-	normal[2] = rigid_plane->loadTexture("models\\pbr\\Wood\\Sphere3D_1_defaultMat_Normal.png");
-	metallic[2] = rigid_plane->loadTexture("models\\pbr\\Wood\\Sphere3D_1_defaultMat_Metallic.png");
-	roughness[2] = rigid_plane->loadTexture("models\\pbr\\Wood\\Sphere3D_1_defaultMat_Roughness.png");
-	ao[2] = rigid_plane->loadTexture("models\\pbr\\Wood\\ao.png");
-
-	// rusted_iron
-	albedo[3] = rigid_plane->loadTexture("models\\pbr\\rusted-iron\\Sphere3D_1_defaultMat_BaseColor.png");
-	normal[3] = rigid_plane->loadTexture("models\\pbr\\rusted-iron\\Sphere3D_1_defaultMat_Normal.png");
-	metallic[3] = rigid_plane->loadTexture("models\\pbr\\rusted-iron\\Sphere3D_1_defaultMat_Metallic.png");
-	roughness[3] = rigid_plane->loadTexture("models\\pbr\\rusted-iron\\Sphere3D_1_defaultMat_Roughness.png");
-	ao[3] = rigid_plane->loadTexture("models\\pbr\\rusted-iron\\ao.png");
-
-	// fabric
-	albedo[4] = rigid_plane->loadTexture("models\\pbr\\Fabric\\Sphere3D_1_defaultMat_BaseColor.png");
-	normal[4] = rigid_plane->loadTexture("models\\pbr\\Fabric\\Sphere3D_1_defaultMat_Normal.png");
-	metallic[4] = rigid_plane->loadTexture("models\\pbr\\Fabric\\Sphere3D_1_defaultMat_Metallic.png");
-	roughness[4] = rigid_plane->loadTexture("models\\pbr\\Fabric\\Sphere3D_1_defaultMat_Roughness.png");
-	ao[4] = rigid_plane->loadTexture("models\\pbr\\Fabric\\ao.png");
-
-	// torn-fabric
-	albedo[5] = rigid_plane->loadTexture("models\\pbr\\TornFabric\\Sphere3D_1_defaultMat_BaseColor.png");
-	normal[5] = rigid_plane->loadTexture("models\\pbr\\TornFabric\\Sphere3D_1_defaultMat_Normal.png");
-	metallic[5] = rigid_plane->loadTexture("models\\pbr\\TornFabric\\Sphere3D_1_defaultMat_Metallic.png");
-	roughness[5] = rigid_plane->loadTexture("models\\pbr\\TornFabric\\Sphere3D_1_defaultMat_Roughness.png");
-	ao[5] = rigid_plane->loadTexture("models\\pbr\\TornFabric\\ao.png");
-
-	// aluminium
-	albedo[6] = rigid_plane->loadTexture("models\\pbr\\Aluminium\\Sphere3D_1_defaultMat_BaseColor.png");
-	normal[6] = rigid_plane->loadTexture("models\\pbr\\Aluminium\\Sphere3D_1_defaultMat_Normal.png");
-	metallic[6] = rigid_plane->loadTexture("models\\pbr\\Aluminium\\Sphere3D_1_defaultMat_Metallic.png");
-	roughness[6] = rigid_plane->loadTexture("models\\pbr\\Aluminium\\Sphere3D_1_defaultMat_Roughness.png");
-	ao[6] = rigid_plane->loadTexture("models\\pbr\\Aluminium\\ao.png");
-
-	// copper
-	albedo[7] = rigid_plane->loadTexture("models\\pbr\\Copper\\Sphere3D_1_defaultMat_BaseColor.png");
-	normal[7] = rigid_plane->loadTexture("models\\pbr\\Copper\\Sphere3D_1_defaultMat_Normal.png");
-	metallic[7] = rigid_plane->loadTexture("models\\pbr\\Copper\\Sphere3D_1_defaultMat_Metallic.png");
-	roughness[7] = rigid_plane->loadTexture("models\\pbr\\Copper\\Sphere3D_1_defaultMat_Roughness.png");
-	ao[7] = rigid_plane->loadTexture("models\\pbr\\Copper\\ao.png");
-
-	// concrete
-	albedo[8] = rigid_plane->loadTexture("models\\pbr\\Concrete\\Sphere3D_1_defaultMat_BaseColor.png");
-	normal[8] = rigid_plane->loadTexture("models\\pbr\\Concrete\\Sphere3D_1_defaultMat_Normal.png");
-	metallic[8] = rigid_plane->loadTexture("models\\pbr\\Concrete\\Sphere3D_1_defaultMat_Metallic.png");
-	roughness[8] = rigid_plane->loadTexture("models\\pbr\\Concrete\\Sphere3D_1_defaultMat_Roughness.png");
-	ao[8] = rigid_plane->loadTexture("models\\pbr\\Concrete\\ao.png");
-
-	// leather
-	albedo[9] = rigid_plane->loadTexture("models\\pbr\\Leather\\Sphere3D_1_defaultMat_BaseColor.png");
-	normal[9] = rigid_plane->loadTexture("models\\pbr\\Leather\\Sphere3D_1_defaultMat_Normal.png");
-	metallic[9] = rigid_plane->loadTexture("models\\pbr\\Leather\\Sphere3D_1_defaultMat_Metallic.png");
-	roughness[9] = rigid_plane->loadTexture("models\\pbr\\Leather\\Sphere3D_1_defaultMat_Roughness.png");
-	ao[9] = rigid_plane->loadTexture("models\\pbr\\Leather\\ao.png");
-
-	// gold
-	albedo[10] = rigid_plane->loadTexture("models\\pbr\\gold\\Sphere3D_1_defaultMat_BaseColor.png");
-	normal[10] = rigid_plane->loadTexture("models\\pbr\\gold\\Sphere3D_1_defaultMat_Normal.png");
-	metallic[10] = rigid_plane->loadTexture("models\\pbr\\gold\\Sphere3D_1_defaultMat_Metallic.png");
-	roughness[10] = rigid_plane->loadTexture("models\\pbr\\gold\\Sphere3D_1_defaultMat_Roughness.png");
-	ao[10] = rigid_plane->loadTexture("models\\pbr\\gold\\ao.png");
-
-	delete rigid_plane;
+	materials.Load();
 }
-
-int Scene::ChangePBRTexture(TextureType type, unsigned index, bool isSoftbodyObj)
+void Scene::ChangePBRTexture(TextureType type, unsigned index, bool isSoftbodyObj)
 {
-	int to_return = 0;
-	if (isSoftbodyObj)
+	// objects only keep the material index, DrawObjs picks the layer
+	if (!isSoftbodyObj)
 	{
-		if (index > softbody_obj.size())
-		{
-			// change all text
-			for (auto obj : softbody_obj)
-			{
-				if (type == PLASTIC)
-				{
-					(*obj).albedo = albedo[0];
-					(*obj).normal = normal[0];
-					(*obj).metallic = metallic[0];
-					(*obj).roughness = roughness[0];
-					(*obj).ao = ao[0];
-					(*obj).m_textype = PLASTIC;
-				}
-				else if (type == STEEL)
-				{
-					(*obj).albedo = albedo[1];
-					(*obj).normal = normal[1];
-					(*obj).metallic = metallic[1];
-					(*obj).roughness = roughness[1];
-					(*obj).ao = ao[1];
-					(*obj).m_textype = STEEL;
-					to_return = 5;
-				}
-				else if (type == WOOD)
-				{
-					(*obj).albedo = albedo[2];
-					(*obj).normal = normal[2];
-					(*obj).metallic = metallic[2];
-					(*obj).roughness = roughness[2];
-					(*obj).ao = ao[2];
-					(*obj).m_textype = WOOD;
-					to_return = 10;
-				}
-				else if (type == RUSTED_IRON)
-				{
-					(*obj).albedo = albedo[3];
-					(*obj).normal = normal[3];
-					(*obj).metallic = metallic[3];
-					(*obj).roughness = roughness[3];
-					(*obj).ao = ao[3];
-					(*obj).m_textype = RUSTED_IRON;
-					to_return = 15;
-				}
-				else if (type == FABRIC)
-				{
-					(*obj).albedo = albedo[4];
-					(*obj).normal = normal[4];
-					(*obj).metallic = metallic[4];
-					(*obj).roughness = roughness[4];
-					(*obj).ao = ao[4];
-					(*obj).m_textype = FABRIC;
-					to_return = 20;
-				}
-				else if (type == TORN_FABRIC)
-				{
-					(*obj).albedo = albedo[5];
-					(*obj).normal = normal[5];
-					(*obj).metallic = metallic[5];
-					(*obj).roughness = roughness[5];
-					(*obj).ao = ao[5];
-					(*obj).m_textype = TORN_FABRIC;
-					to_return = 25;
-				}
-				else if (type == ALUMINIUM)
-				{
-					(*obj).albedo = albedo[6];
-					(*obj).normal = normal[6];
-					(*obj).metallic = metallic[6];
-					(*obj).roughness = roughness[6];
-					(*obj).ao = ao[6];
-					(*obj).m_textype = ALUMINIUM;
-					to_return = 30;
-				}
-				else if (type == COPPER)
-				{
-					(*obj).albedo = albedo[7];
-					(*obj).normal = normal[7];
-					(*obj).metallic = metallic[7];
-					(*obj).roughness = roughness[7];
-					(*obj).ao = ao[7];
-					(*obj).m_textype = COPPER;
-					to_return = 35;
-				}
-				else if (type == CONCRETE)
-				{
-					(*obj).albedo = albedo[8];
-					(*obj).normal = normal[8];
-					(*obj).metallic = metallic[8];
-					(*obj).roughness = roughness[8];
-					(*obj).ao = ao[8];
-					(*obj).m_textype = CONCRETE;
-					to_return = 40;
-				}
-				else if (type == LEATHER)
-				{
-					(*obj).albedo = albedo[9];
-					(*obj).normal = normal[9];
-					(*obj).metallic = metallic[9];
-					(*obj).roughness = roughness[9];
-					(*obj).ao = ao[9];
-					(*obj).m_textype = LEATHER;
-					to_return = 45;
-				}
-				else if (type == GOLD)
-				{
-					(*obj).albedo = albedo[10];
-					(*obj).normal = normal[10];
-					(*obj).metallic = metallic[10];
-					(*obj).roughness = roughness[10];
-					(*obj).ao = ao[10];
-					(*obj).m_textype = GOLD;
-					to_return = 50;
-				}
-			}
-		}
-		else
-		{
-			if (type == PLASTIC)
-			{
-				softbody_obj[index]->albedo = albedo[0];
-				softbody_obj[index]->normal = normal[0];
-				softbody_obj[index]->metallic = metallic[0];
-				softbody_obj[index]->roughness = roughness[0];
-				softbody_obj[index]->ao = ao[0];
-				softbody_obj[index]->m_textype = PLASTIC;
-			}
-			else if (type == STEEL)
-			{
-				softbody_obj[index]->albedo = albedo[1];
-				softbody_obj[index]->normal = normal[1];
-				softbody_obj[index]->metallic = metallic[1];
-				softbody_obj[index]->roughness = roughness[1];
-				softbody_obj[index]->ao = ao[1];
-				softbody_obj[index]->m_textype = STEEL;
-				to_return = 5;
-			}
-			else if (type == WOOD)
-			{
-				softbody_obj[index]->albedo = albedo[2];
-				softbody_obj[index]->normal = normal[2];
-				softbody_obj[index]->metallic = metallic[2];
-				softbody_obj[index]->roughness = roughness[2];
-				softbody_obj[index]->ao = ao[2];
-				softbody_obj[index]->m_textype = WOOD;
-				to_return = 10;
-			}
-			else if (type == RUSTED_IRON)
-			{
-				softbody_obj[index]->albedo = albedo[3];
-				softbody_obj[index]->normal = normal[3];
-				softbody_obj[index]->metallic = metallic[3];
-				softbody_obj[index]->roughness = roughness[3];
-				softbody_obj[index]->ao = ao[3];
-				softbody_obj[index]->m_textype = RUSTED_IRON;
-				to_return = 15;
-			}
-			else if (type == FABRIC)
-			{
-				softbody_obj[index]->albedo = albedo[4];
-				softbody_obj[index]->normal = normal[4];
-				softbody_obj[index]->metallic = metallic[4];
-				softbody_obj[index]->roughness = roughness[4];
-				softbody_obj[index]->ao = ao[4];
-				softbody_obj[index]->m_textype = FABRIC;
-				to_return = 20;
-			}
-			else if (type == TORN_FABRIC)
-			{
-				softbody_obj[index]->albedo = albedo[5];
-				softbody_obj[index]->normal = normal[5];
-				softbody_obj[index]->metallic = metallic[5];
-				softbody_obj[index]->roughness = roughness[5];
-				softbody_obj[index]->ao = ao[5];
-				softbody_obj[index]->m_textype = TORN_FABRIC;
-				to_return = 25;
-			}
-			else if (type == ALUMINIUM)
-			{
-				softbody_obj[index]->albedo = albedo[6];
-				softbody_obj[index]->normal = normal[6];
-				softbody_obj[index]->metallic = metallic[6];
-				softbody_obj[index]->roughness = roughness[6];
-				softbody_obj[index]->ao = ao[6];
-				softbody_obj[index]->m_textype = ALUMINIUM;
-				to_return = 30;
-			}
-			else if (type == COPPER)
-			{
-				softbody_obj[index]->albedo = albedo[7];
-				softbody_obj[index]->normal = normal[7];
-				softbody_obj[index]->metallic = metallic[7];
-				softbody_obj[index]->roughness = roughness[7];
-				softbody_obj[index]->ao = ao[7];
-				softbody_obj[index]->m_textype = COPPER;
-				to_return = 35;
-			}
-			else if (type == CONCRETE)
-			{
-				softbody_obj[index]->albedo = albedo[8];
-				softbody_obj[index]->normal = normal[8];
-				softbody_obj[index]->metallic = metallic[8];
-				softbody_obj[index]->roughness = roughness[8];
-				softbody_obj[index]->ao = ao[8];
-				softbody_obj[index]->m_textype = CONCRETE;
-				to_return = 40;
-			}
-			else if (type == LEATHER)
-			{
-				softbody_obj[index]->albedo = albedo[9];
-				softbody_obj[index]->normal = normal[9];
-				softbody_obj[index]->metallic = metallic[9];
-				softbody_obj[index]->roughness = roughness[9];
-				softbody_obj[index]->ao = ao[9];
-				softbody_obj[index]->m_textype = LEATHER;
-				to_return = 45;
-			}
-			else if (type == GOLD)
-			{
-				softbody_obj[index]->albedo = albedo[10];
-				softbody_obj[index]->normal = normal[10];
-				softbody_obj[index]->metallic = metallic[10];
-				softbody_obj[index]->roughness = roughness[10];
-				softbody_obj[index]->ao = ao[10];
-				softbody_obj[index]->m_textype = GOLD;
-				to_return = 50;
-			}
-		}
+		for (auto obj : pbr_obj)
+			(*obj).m_textype = type;
 	}
+	else if (index < softbody_obj.size())
+		softbody_obj[index]->m_textype = type;
 	else
 	{
-	// change all text
-	for (auto obj : pbr_obj)
-	{
-		if (type == PLASTIC)
-		{
-			(*obj).albedo = albedo[0];
-			(*obj).normal = normal[0];
-			(*obj).metallic = metallic[0];
-			(*obj).roughness = roughness[0];
-			(*obj).ao = ao[0];
-			(*obj).m_textype = PLASTIC;
-		}
-		else if (type == STEEL)
-		{
-			(*obj).albedo = albedo[1];
-			(*obj).normal = normal[1];
-			(*obj).metallic = metallic[1];
-			(*obj).roughness = roughness[1];
-			(*obj).ao = ao[1];
-			(*obj).m_textype = STEEL;
-			to_return = 5;
-		}
-		else if (type == WOOD)
-		{
-			(*obj).albedo = albedo[2];
-			(*obj).normal = normal[2];
-			(*obj).metallic = metallic[2];
-			(*obj).roughness = roughness[2];
-			(*obj).ao = ao[2];
-			(*obj).m_textype = WOOD;
-			to_return = 10;
-		}
-		else if (type == RUSTED_IRON)
-		{
-			(*obj).albedo = albedo[3];
-			(*obj).normal = normal[3];
-			(*obj).metallic = metallic[3];
-			(*obj).roughness = roughness[3];
-			(*obj).ao = ao[3];
-			(*obj).m_textype = RUSTED_IRON;
-			to_return = 15;
-		}
-		else if (type == FABRIC)
-		{
-			(*obj).albedo = albedo[4];
-			(*obj).normal = normal[4];
-			(*obj).metallic = metallic[4];
-			(*obj).roughness = roughness[4];
-			(*obj).ao = ao[4];
-			(*obj).m_textype = FABRIC;
-			to_return = 20;
-		}
-		else if (type == TORN_FABRIC)
-		{
-			(*obj).albedo = albedo[5];
-			(*obj).normal = normal[5];
-			(*obj).metallic = metallic[5];
-			(*obj).roughness = roughness[5];
-			(*obj).ao = ao[5];
-			(*obj).m_textype = TORN_FABRIC;
-			to_return = 25;
-		}
-		else if (type == ALUMINIUM)
-		{
-			(*obj).albedo = albedo[6];
-			(*obj).normal = normal[6];
-			(*obj).metallic = metallic[6];
-			(*obj).roughness = roughness[6];
-			(*obj).ao = ao[6];
-			(*obj).m_textype = ALUMINIUM;
-			to_return = 30;
-		}
-		else if (type == COPPER)
-		{
-			(*obj).albedo = albedo[7];
-			(*obj).normal = normal[7];
-			(*obj).metallic = metallic[7];
-			(*obj).roughness = roughness[7];
-			(*obj).ao = ao[7];
-			(*obj).m_textype = COPPER;
-			to_return = 35;
-		}
-		else if (type == CONCRETE)
-		{
-			(*obj).albedo = albedo[8];
-			(*obj).normal = normal[8];
-			(*obj).metallic = metallic[8];
-			(*obj).roughness = roughness[8];
-			(*obj).ao = ao[8];
-			(*obj).m_textype = CONCRETE;
-			to_return = 40;
-		}
-		else if (type == LEATHER)
-		{
-			(*obj).albedo = albedo[9];
-			(*obj).normal = normal[9];
-			(*obj).metallic = metallic[9];
-			(*obj).roughness = roughness[9];
-			(*obj).ao = ao[9];
-			(*obj).m_textype = LEATHER;
-			to_return = 45;
-		}
-		else if (type == GOLD)
-		{
-			(*obj).albedo = albedo[10];
-			(*obj).normal = normal[10];
-			(*obj).metallic = metallic[10];
-			(*obj).roughness = roughness[10];
-			(*obj).ao = ao[10];
-			(*obj).m_textype = GOLD;
-			to_return = 50;
-		}
+		// change all text
+		for (auto obj : softbody_obj)
+			(*obj).m_textype = type;
 	}
-	}
-	return to_return;
-}
\ No newline at end of file
+}
@@ -16,22 +16,20 @@ End Header --------------------------------------------------------*/
 #define SCENE_H
 
 #include "Object.h"
+#include "InstanceRenderer.h"
+#include "MaterialTable.h"
+#include "UniformBlocks.h"
 #include "Base.h"
 #include "Physics.h"
 #include "Camera.h"
 #include "Shader.h"
 #include "Light.h"
+#include "SceneContent.h"
 #include "imgui-master\imgui.h"
 #include "imgui-master\imgui_impl_glfw.h"
 #include "imgui-master\imgui_impl_opengl3.h"
 #include "GLFW\glfw3.h"
 
-#define S_DIMENSION 12
-#define MID_S_DIMENSION 16
-#define HIGH_S_DIMENSION 24
-#define P_DIMENSION 64
-
-const unsigned pbr_number = 11;
 const unsigned light_num = 20;
 
 class Scene {
@@ -43,6 +41,7 @@ public:
 		InitAllPBRTexture();
 	};
 	~Scene() {};
+	// shaders, uniform blocks and IBL maps, once. They outlive scene switches, only DeleteBuffers frees them
 	void Init(GLFWwindow* window, Camera* camera);
 	void Update(GLFWwindow* window, Camera* camera, float dt);
 
@@ -66,10 +65,12 @@ public:
 	void DrawObjs(Camera* camera, unsigned scene_num);
 
 	void InitAllPBRTexture();
-	int ChangePBRTexture(TextureType type, unsigned index, bool isSoftbodyObj);
+	void ChangePBRTexture(TextureType type, unsigned index, bool isSoftbodyObj);
+	// rebuilds the current scene's objects, the renderer resources stay
 	void Reload(Camera* camera);
+	void ChangeScene(unsigned scene, Camera* camera);
 
-	void ImGuiUpdate(GLFWwindow* window, Camera* camera, float dt);
+	void ImGuiUpdate(Camera* camera, float dt);
 	void ImGuirender();
 	void ImGuiShutdown();
 
@@ -79,9 +80,22 @@ private:
 	std::vector<Object*> light_obj;
 	std::vector<SoftBodyPhysics*> softbody_obj;
 	std::vector<Light> light;
+	// scene 5's spheres and lights, one draw per mesh instead of one per sphere
+	InstanceRenderer sphere_instances;
+	InstanceRenderer light_instances;
+	// camera, lights and material for every scene shader, uploaded once per frame
+	UniformBlocks uniform_blocks;
+
+	// the SceneXInit of curr_scene
+	void InitContent(Camera* camera);
+	void AddPBRSphere(glm::vec3 position);
+	// light_obj positions and colors into the lights block
+	void UploadLights();
 
 	void push_object(Object* _obj) { pbr_obj.push_back(_obj); }
 	void push_softbody_object(SoftBodyPhysics* _obj) { softbody_obj.push_back(_obj); }
+	// rigid bodies go to m_physics and pbr_obj, softbodies to m_physics and softbody_obj
+	void PushContent(const SceneContent& content);
 	unsigned curr_scene;
 	int width, height;
 	float aspect;
@@ -105,11 +119,10 @@ private:
 	unsigned int brdfLUTTexture = 0;
 	unsigned int hdrTexture = 0;
 
-	unsigned int albedo[pbr_number] = { 0 };
-	unsigned int normal[pbr_number] = { 0 };
-	unsigned int metallic[pbr_number] = { 0 };
-	unsigned int roughness[pbr_number] = { 0 };
-	unsigned int ao[pbr_number] = { 0 };
+	// every PBR texture set, objects pick theirs by m_textype. Loads in the background from the constructor
+	MaterialTable materials;
+	// pbr_obj and softbody_obj by material, and whether to draw as lines
+	std::vector<std::pair<Object*, bool>> draw_order;
 
 	int dimension_;
 
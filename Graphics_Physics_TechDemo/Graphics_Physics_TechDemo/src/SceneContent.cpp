@@ -0,0 +1,185 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: SceneContent.cpp
+Purpose: Rigid and soft bodies of scene 0 - 3
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#include "SceneContent.h"
+#include "Base.h"
+
+namespace
+{
+	void Scene0Content(SceneContent& content)
+	{
+		Object* rigid_plane = new Object(O_PLANE, glm::vec3(4.f, -4.f, 1.f), glm::vec3(7.f, 1.f, 0.5f), P_DIMENSION);
+		rigid_plane->rotation = 1.f;
+		content.rigid.push_back(rigid_plane);
+
+		Object* rigid_plane_1 = new Object(O_PLANE, glm::vec3(4.f, -4.f, 2.f), glm::vec3(7.f, 1.f, 0.5f), P_DIMENSION);
+		rigid_plane_1->rotation = 1.f;
+		content.rigid.push_back(rigid_plane_1);
+
+		Object* rigid_plane_2 = new Object(O_PLANE, glm::vec3(1.3f, -7.f, 0.5f), glm::vec3(4.f, 1.f, 4.f), P_DIMENSION); // 2
+		rigid_plane_2->rotation = -1.f;
+		content.rigid.push_back(rigid_plane_2);
+
+		Object* rigid_plane_3 = new Object(O_PLANE, glm::vec3(4.f, -10.3f, 0.5f), glm::vec3(4.f, 1.f, 4.f), P_DIMENSION); // 3
+		rigid_plane_3->rotation = 1.f;
+		content.rigid.push_back(rigid_plane_3);
+
+		Object* rigid_plane_4 = new Object(O_PLANE, glm::vec3(1.3f, -13.f, 0.5f), glm::vec3(4.f, 1.f, 4.f), P_DIMENSION); // 2
+		rigid_plane_4->rotation = -1.f;
+		content.rigid.push_back(rigid_plane_4);
+
+		Object* rigid_plane_5 = new Object(O_PLANE, glm::vec3(4.f, -16.3f, 0.5f), glm::vec3(4.f, 1.f, 4.f), P_DIMENSION); // 3
+		rigid_plane_5->rotation = 1.f;
+		content.rigid.push_back(rigid_plane_5);
+
+		Object* rigid_plane_6 = new Object(O_PLANE, glm::vec3(1.3f, -19.f, 0.5f), glm::vec3(4.f, 60.f, 4.f), P_DIMENSION); // 2
+		rigid_plane_6->rotation = -0.1f;
+		content.rigid.push_back(rigid_plane_6);
+
+		Object* rigid_plane_7 = new Object(O_PLANE, glm::vec3(8.f, -40.3f, 0.5f), glm::vec3(4.f, 40.f, 4.f), P_DIMENSION); // 3
+		rigid_plane_7->rotation = 0.1f;
+		content.rigid.push_back(rigid_plane_7);
+
+		//right
+		Object* rigid_cube_1 = new Object(O_PLANE, glm::vec3(4.5f, -52.f, 0.5f), glm::vec3(2.f, 2.f, 3.0f), P_DIMENSION);
+		rigid_cube_1->axis = glm::vec3(0.f, 0.f, 1.f);
+		rigid_cube_1->rotation = 1.5708f;
+		content.rigid.push_back(rigid_cube_1);
+
+		//left
+		Object* rigid_cube_2 = new Object(O_PLANE, glm::vec3(1.5f, -50.f, 0.5f), glm::vec3(2.f, 2.f, 3.0f), P_DIMENSION);
+		rigid_cube_2->axis = glm::vec3(0.f, 0.f, 1.f);
+		rigid_cube_2->rotation = -1.5708f;
+		content.rigid.push_back(rigid_cube_2);
+
+		//back
+		Object* rigid_cube_3 = new Object(O_PLANE, glm::vec3(1.5f, -50.f, 0.5f), glm::vec3(3.0f, 2.f, 2.f), P_DIMENSION);
+		rigid_cube_3->axis = glm::vec3(1.f, 0.f, 0.f);
+		rigid_cube_3->rotation = 1.5708f;
+		content.rigid.push_back(rigid_cube_3);
+
+		Object* rigid_plane_ = new Object(O_PLANE, glm::vec3(1.5f, -52.f, 0.5f), glm::vec3(3.0f, 3.0f, 3.0f), P_DIMENSION);
+		content.rigid.push_back(rigid_plane_);
+
+		SoftBodyPhysics* sb_sphere = new SoftBodyPhysics(O_SPHERE, glm::vec3(6.5f, 0.f, 2.f), glm::vec3(1.f, 1.f, 1.f), MID_S_DIMENSION);
+		sb_sphere->stiffness = 0.35f;
+		sb_sphere->m_mass = 0.5f;
+		content.softbody.push_back(sb_sphere);
+	}
+
+	void Scene1Content(SceneContent& content)
+	{
+		content.rigid.push_back(new Object(O_SPHERE, glm::vec3(1.2f, -2.5f, 4.0f), glm::vec3(1.f, 1.f, 1.f), MID_S_DIMENSION)); // mid
+		content.rigid.push_back(new Object(O_SPHERE, glm::vec3(1.2f, -0.5f, 2.0f), glm::vec3(1.f, 1.f, 1.f), MID_S_DIMENSION)); // top
+		content.rigid.push_back(new Object(O_SPHERE, glm::vec3(1.2f, -4.5f, 6.0f), glm::vec3(1.f, 1.f, 1.f), MID_S_DIMENSION)); // bottom
+
+		SoftBodyPhysics* plane = new SoftBodyPhysics(O_PLANE, glm::vec3(0, 1.5f, 1.f), glm::vec3(6.f, 1.f, 10.f), P_DIMENSION);
+		plane->m_mass = 0.15f;
+		plane->stiffness = 0.8f;
+		content.softbody.push_back(plane);
+	}
+
+	void Scene2Content(SceneContent& content)
+	{
+		Object* rigid_plane = new Object(O_PLANE, glm::vec3(4.f, 0.5f, -2.f), glm::vec3(10.f, 10.f, 4.f), P_DIMENSION);
+		rigid_plane->rotation = 0.5f;
+		content.rigid.push_back(rigid_plane);
+
+		Object* rigid_plane_2 = new Object(O_PLANE, glm::vec3(0.f, 5.f, -10.f), glm::vec3(4.f, 10.f, 10.f), P_DIMENSION);
+		rigid_plane_2->axis = glm::vec3(1.f, 0.f, 0.f);
+		rigid_plane_2->rotation = 0.5f;
+		content.rigid.push_back(rigid_plane_2);
+
+		Object* rigid_plane_3 = new Object(O_PLANE, glm::vec3(-9.f, 5.f, -2.f), glm::vec3(10.f, 10.f, 4.f), P_DIMENSION);
+		rigid_plane_3->axis = glm::vec3(0.f, 0.f, -1.f);
+		rigid_plane_3->rotation = 0.5f;
+		content.rigid.push_back(rigid_plane_3);
+
+		Object* rigid_plane_4 = new Object(O_PLANE, glm::vec3(-13.f, -5.f, -13.f), glm::vec3(30.f, 30.f, 30.f), P_DIMENSION);
+		content.rigid.push_back(rigid_plane_4);
+
+		content.softbody.push_back(new SoftBodyPhysics(O_SPHERE, glm::vec3(10.f, 6.8f, 0.f), glm::vec3(1.f, 1.f, 1.f), S_DIMENSION));
+		content.softbody.push_back(new SoftBodyPhysics(O_SPHERE, glm::vec3(2.f, 7.f, -8.f), glm::vec3(1.f, 1.f, 1.f), S_DIMENSION));
+		content.softbody.push_back(new SoftBodyPhysics(O_SPHERE, glm::vec3(-8.f, 7.f, 0.f), glm::vec3(1.f, 1.f, 1.f), S_DIMENSION));
+	}
+
+	void Scene3Content(SceneContent& content)
+	{
+		for (int i = 0; i < 10; ++i)
+		{
+			SoftBodyPhysics* sphere = new SoftBodyPhysics(O_SPHERE, glm::vec3(3.f, 3.f + (float)i * 5.f, 2.f), glm::vec3(1.f, 1.f, 1.f), S_DIMENSION);
+			sphere->stiffness = 0.35f;
+			content.softbody.push_back(sphere);
+		}
+
+		//front
+		Object* rigid_cube_0 = new Object(O_PLANE, glm::vec3(0.f, -10.f, 7.f), glm::vec3(7.f, 2.f, 2.f), P_DIMENSION);
+		rigid_cube_0->axis = glm::vec3(1.f, 0.f, 0.f);
+		rigid_cube_0->rotation = -1.5708f;
+		content.rigid.push_back(rigid_cube_0);
+
+		//right
+		Object* rigid_cube_1 = new Object(O_PLANE, glm::vec3(7.f, -10.f, 0.f), glm::vec3(2.f, 2.f, 7.f), P_DIMENSION);
+		rigid_cube_1->axis = glm::vec3(0.f, 0.f, 1.f);
+		rigid_cube_1->rotation = 1.5708f;
+		content.rigid.push_back(rigid_cube_1);
+
+		//left
+		Object* rigid_cube_2 = new Object(O_PLANE, glm::vec3(0.f, -8.f, 0.f), glm::vec3(2.f, 2.f, 7.f), P_DIMENSION);
+		rigid_cube_2->axis = glm::vec3(0.f, 0.f, 1.f);
+		rigid_cube_2->rotation = -1.5708f;
+		content.rigid.push_back(rigid_cube_2);
+
+		//back
+		Object* rigid_cube_3 = new Object(O_PLANE, glm::vec3(0.f, -8.f, 0.f), glm::vec3(7.f, 2.f, 2.f), P_DIMENSION);
+		rigid_cube_3->axis = glm::vec3(1.f, 0.f, 0.f);
+		rigid_cube_3->rotation = 1.5708f;
+		content.rigid.push_back(rigid_cube_3);
+
+		Object* rigid_plane = new Object(O_PLANE, glm::vec3(0.f, -10.f, 0.f), glm::vec3(7.f, 7.f, 7.f), P_DIMENSION);
+		content.rigid.push_back(rigid_plane);
+	}
+}
+
+void BuildSceneContent(unsigned scene, SceneContent& content)
+{
+	if (scene == 0)
+		Scene0Content(content);
+	else if (scene == 1)
+		Scene1Content(content);
+	else if (scene == 2)
+		Scene2Content(content);
+	else if (scene == 3)
+		Scene3Content(content);
+}
+
+uint64_t ParticleChecksum(const std::vector<SoftBodyPhysics*>& softbody, double& sum)
+{
+	uint64_t hash = 14695981039346656037ull;
+	sum = 0.0;
+	for (auto soft : softbody)
+	{
+		const ParticleArray& ver = soft->m_scaled_ver;
+		for (unsigned i = 0; i < ver.size(); ++i)
+		{
+			float p[3] = { ver.x[i], ver.y[i], ver.z[i] };
+			const unsigned char* bytes = reinterpret_cast<const unsigned char*>(p);
+			for (unsigned b = 0; b < sizeof(p); ++b)
+			{
+				hash ^= bytes[b];
+				hash *= 1099511628211ull;
+			}
+			sum += p[0] + p[1] + p[2];
+		}
+	}
+	return hash;
+}
@@ -0,0 +1,43 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: SceneContent.h
+Purpose: Physics objects of the demo scenes, shared by Scene and the headless runner
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#pragma once
+
+#ifndef SCENE_CONTENT_H
+#define SCENE_CONTENT_H
+
+#include <cstdint>
+#include <vector>
+
+#define S_DIMENSION 12
+#define MID_S_DIMENSION 16
+#define HIGH_S_DIMENSION 24
+#define P_DIMENSION 64
+
+#define SCENE_COUNT 6
+
+class Object;
+class SoftBodyPhysics;
+
+struct SceneContent {
+	std::vector<Object*> rigid;
+	std::vector<SoftBodyPhysics*> softbody;
+};
+
+// rigid and soft bodies of scene 0 - 3 in the order the scenes push them, no GL or materials involved.
+// Scene 4 and 5 only draw, their content stays empty.
+void BuildSceneContent(unsigned scene, SceneContent& content);
+// FNV-1a over the bits of every particle, changes with any difference in the final state.
+// sum is the plain total of the coordinates, for telling how far apart two runs are
+uint64_t ParticleChecksum(const std::vector<SoftBodyPhysics*>& softbody, double& sum);
+
+#endif
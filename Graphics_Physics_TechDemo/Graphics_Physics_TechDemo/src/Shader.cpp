@@ -12,6 +12,7 @@ Creation date: 9/6/2018
 End Header --------------------------------------------------------*/
 #include "Shader.h"
 #include "glad//glad.h"
+#include "UniformBlocks.h"
 
 #include <vector>
 #include <fstream>
@@ -19,162 +20,201 @@ End Header --------------------------------------------------------*/
 
 Shader::~Shader() { glDeleteProgram(m_programId); }
 
-void Shader::CreateShader(const char* vertex_file_path, const char* fragment_file_path,
-	const char* geometry_file_path)
+bool Shader::ReadSource(const char* path, std::string& source)
 {
-	bool UseGeometry = false;
-	if (geometry_file_path != nullptr)
-		UseGeometry = true;
-	// vertex shader
-	m_vertexId = glCreateShader(GL_VERTEX_SHADER);
-
-	std::string VertexShaderCode;
-	std::ifstream VertexShaderStream(vertex_file_path, std::ios::in);
-
-	if (VertexShaderStream.is_open())
+	std::ifstream stream(path, std::ios::in);
+	if (!stream.is_open())
 	{
-		std::stringstream sstr;
-		sstr << VertexShaderStream.rdbuf();
-		VertexShaderCode = sstr.str();
-		VertexShaderStream.close();
-	}
-	else
-	{
-		printf("Impossible to open %s.\n", vertex_file_path);
-		(void)getchar();
-		return;
+		printf("Impossible to open %s.\n", path);
+		return false;
 	}
+	std::stringstream sstr;
+	sstr << stream.rdbuf();
+	source = sstr.str();
+	return true;
+}
+GLuint Shader::CompileStage(GLenum type, const std::string& source, const char* path)
+{
+	GLuint id = glCreateShader(type);
+	char const* sourcePointer = source.c_str();
+	int InfoLogLength;
+	glShaderSource(id, 1, &sourcePointer, NULL);
 
-	std::string FragmentShaderCode;
-	std::ifstream FragmentShaderStream(fragment_file_path, std::ios::in);
+	glCompileShader(id);
 
-	if (FragmentShaderStream.is_open())
+	glGetShaderiv(id, GL_COMPILE_STATUS, &m_result);
+	glGetShaderiv(id, GL_INFO_LOG_LENGTH, &InfoLogLength);
+	if (m_result == GL_FALSE && InfoLogLength > 0)
 	{
-		std::stringstream sstr;
-		sstr << FragmentShaderStream.rdbuf();
-		FragmentShaderCode = sstr.str();
-		FragmentShaderStream.close();
+		std::vector<char> ShaderErrorMessage(static_cast<INT64>(InfoLogLength + 1.0));
+		glGetShaderInfoLog(id, InfoLogLength, nullptr, &ShaderErrorMessage[0]);
+		printf("%s: %s\n", path, &ShaderErrorMessage[0]);
 	}
-	else
+	return id;
+}
+void Shader::LinkProgram(const GLuint* stages, unsigned count, const char* path)
+{
+	// replaces the program a previous Create call made
+	if (m_programId)
+		glDeleteProgram(m_programId);
+	m_programId = glCreateProgram();
+	if (m_programId == 0)
 	{
-		printf("Impossible to open %s.\n", fragment_file_path);
-		(void)getchar();
+		printf("Shader cannot get program id from the other.\n");
 		return;
 	}
+	for (unsigned i = 0; i < count; ++i)
+		glAttachShader(m_programId, stages[i]);
 
-	// vertex shader
-	char const* vertexSourcePointer = VertexShaderCode.c_str();
-	int InfoLogLength;
-	glShaderSource(m_vertexId, 1, &vertexSourcePointer, NULL);
-
-	glCompileShader(m_vertexId);
-
-	glGetShaderiv(m_vertexId, GL_COMPILE_STATUS, &m_result);
-	glGetShaderiv(m_vertexId, GL_INFO_LOG_LENGTH, &InfoLogLength);
+	glLinkProgram(m_programId);
 
-	if (InfoLogLength > 0)
+	int InfoLogLength;
+	glGetProgramiv(m_programId, GL_LINK_STATUS, &m_result);
+	glGetProgramiv(m_programId, GL_INFO_LOG_LENGTH, &InfoLogLength);
+	if (m_result == GL_FALSE && InfoLogLength > 0)
 	{
-		std::vector<char> VertexShaderErrorMessage(static_cast<INT64>(InfoLogLength + 1.0));
-		glGetShaderInfoLog(m_vertexId, InfoLogLength, nullptr, &VertexShaderErrorMessage[0]);
+		std::vector<char> ProgramErrorMessage(static_cast<INT64>(InfoLogLength + 1.0));
+		glGetProgramInfoLog(m_programId, InfoLogLength, nullptr, &ProgramErrorMessage[0]);
+		printf("%s: %s\n", path, &ProgramErrorMessage[0]);
 	}
+	ReflectUniforms();
+}
 
-	// geometry shader
-	if (UseGeometry)
-	{
-		std::string GeometryShaderCode;
-		std::ifstream GeometryShaderStream(geometry_file_path, std::ios::in);
-
-		if (GeometryShaderStream.is_open())
-		{
-			std::stringstream sstr;
-			sstr << GeometryShaderStream.rdbuf();
-			GeometryShaderCode = sstr.str();
-			GeometryShaderStream.close();
-		}
-
-		m_geometryId = glCreateShader(GL_GEOMETRY_SHADER);
-
-		char const* geometrySourcePointer = GeometryShaderCode.c_str();
-
-		glShaderSource(m_geometryId, 1, &geometrySourcePointer, NULL);
-
-		glCompileShader(m_geometryId);
-
-		glGetShaderiv(m_geometryId, GL_COMPILE_STATUS, &m_result);
-		glGetShaderiv(m_geometryId, GL_INFO_LOG_LENGTH, &InfoLogLength);
+void Shader::CreateShader(const char* vertex_file_path, const char* fragment_file_path,
+	const char* geometry_file_path)
+{
+	bool UseGeometry = false;
+	if (geometry_file_path != nullptr)
+		UseGeometry = true;
 
-		if (InfoLogLength > 0)
-		{
-			std::vector<char> GeometryShaderErrorMessage(static_cast<INT64>(InfoLogLength + 1.0));
-			glGetShaderInfoLog(m_geometryId, InfoLogLength, nullptr, &GeometryShaderErrorMessage[0]);
-		}
+	std::string VertexShaderCode, FragmentShaderCode, GeometryShaderCode;
+	if (!ReadSource(vertex_file_path, VertexShaderCode) || !ReadSource(fragment_file_path, FragmentShaderCode)
+		|| (UseGeometry && !ReadSource(geometry_file_path, GeometryShaderCode)))
+	{
+		(void)getchar();
+		return;
 	}
-	// fragment shader
-	m_fragmentId = glCreateShader(GL_FRAGMENT_SHADER);
-
-	char const* fragmentSourcePointer = FragmentShaderCode.c_str();
 
-	glShaderSource(m_fragmentId, 1, &fragmentSourcePointer, NULL);
+	GLuint stages[3];
+	unsigned count = 0;
+	stages[count++] = m_vertexId = CompileStage(GL_VERTEX_SHADER, VertexShaderCode, vertex_file_path);
+	if (UseGeometry)
+		stages[count++] = m_geometryId = CompileStage(GL_GEOMETRY_SHADER, GeometryShaderCode, geometry_file_path);
+	stages[count++] = m_fragmentId = CompileStage(GL_FRAGMENT_SHADER, FragmentShaderCode, fragment_file_path);
 
-	glCompileShader(m_fragmentId);
+	LinkProgram(stages, count, vertex_file_path);
+	for (unsigned i = 0; i < count; ++i)
+		glDeleteShader(stages[i]);
+}
+void Shader::CreateComputeShader(const char* compute_file_path)
+{
+	std::string ComputeShaderCode;
+	if (!ReadSource(compute_file_path, ComputeShaderCode))
+		return;
 
-	glGetShaderiv(m_fragmentId, GL_COMPILE_STATUS, &m_result);
-	glGetShaderiv(m_fragmentId, GL_INFO_LOG_LENGTH, &InfoLogLength);
-	if (InfoLogLength > 0)
+	GLuint computeId = CompileStage(GL_COMPUTE_SHADER, ComputeShaderCode, compute_file_path);
+	LinkProgram(&computeId, 1, compute_file_path);
+	glDeleteShader(computeId);
+}
+void Shader::ReflectUniforms()
+{
+	// the shared blocks, a program without them gets GL_INVALID_INDEX and is skipped
+	const char* const block_names[] = { FRAME_BLOCK_NAME, LIGHTS_BLOCK_NAME, MATERIAL_BLOCK_NAME };
+	const GLuint block_bindings[] = { FRAME_BLOCK_BINDING, LIGHTS_BLOCK_BINDING, MATERIAL_BLOCK_BINDING };
+	for (unsigned i = 0; i < 3; ++i)
 	{
-		std::vector<char> FragmentShaderErrorMessage(static_cast<INT64>(InfoLogLength + 1.0));
-		glGetShaderInfoLog(m_fragmentId, InfoLogLength, nullptr, &FragmentShaderErrorMessage[0]);
+		GLuint index = glGetUniformBlockIndex(m_programId, block_names[i]);
+		if (index != GL_INVALID_INDEX)
+			glUniformBlockBinding(m_programId, index, block_bindings[i]);
 	}
 
-	// link to program
-	m_programId = glCreateProgram();
-	if (m_programId == 0)
+	m_uniforms.clear();
+	GLint count = 0, max_length = 0;
+	glGetProgramiv(m_programId, GL_ACTIVE_UNIFORMS, &count);
+	glGetProgramiv(m_programId, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+	std::vector<char> buffer(max_length + 1);
+	for (GLint i = 0; i < count; ++i)
 	{
-		printf("Shader cannot get program id from the other.\n");
-	}
-	else
-	{
-		glAttachShader(m_programId, m_vertexId);
-		if (UseGeometry)
-			glAttachShader(m_programId, m_geometryId);
-		glAttachShader(m_programId, m_fragmentId);
-
-		glLinkProgram(m_programId);
-
-		glGetProgramiv(m_programId, GL_LINK_STATUS, &m_result);
-		glGetProgramiv(m_programId, GL_INFO_LOG_LENGTH, &InfoLogLength);
-
-		if (InfoLogLength > 0) {
-			std::vector<char> ProgramErrorMessage(static_cast<INT64>(InfoLogLength + 1.0));
-			glGetProgramInfoLog(m_programId, InfoLogLength, nullptr, &ProgramErrorMessage[0]);
+		GLint size = 0;
+		GLenum type;
+		GLsizei length = 0;
+		glGetActiveUniform(m_programId, i, static_cast<GLsizei>(buffer.size()), &length, &size, &type, &buffer[0]);
+		std::string name(&buffer[0], length);
+		// members of uniform blocks have no location
+		GLint location = glGetUniformLocation(m_programId, name.c_str());
+		if (location < 0)
+			continue;
+		// arrays are reported as name[0], register the bare name and every element
+		size_t bracket = name.size() > 3 ? name.rfind("[0]") : std::string::npos;
+		if (bracket != std::string::npos && bracket + 3 == name.size())
+		{
+			std::string base = name.substr(0, bracket);
+			m_uniforms[base] = location;
+			for (GLint e = 0; e < size; ++e)
+			{
+				std::string element = base + "[" + std::to_string(e) + "]";
+				m_uniforms[element] = glGetUniformLocation(m_programId, element.c_str());
+			}
 		}
+		else
+			m_uniforms[name] = location;
 	}
-	glDeleteShader(m_vertexId);
-	if (UseGeometry)
-		glDeleteShader(m_geometryId);
-	glDeleteShader(m_fragmentId);
+	m_common.model = GetUniform("model");
+	m_common.octahedral_normals = GetUniform("octahedral_normals");
+	m_common.instanced = GetUniform("instanced");
+	m_common.instance_material = GetUniform("instance_material");
+	m_common.material = GetUniform("material");
 }
 void Shader::Use() const
 {
 	glUseProgram(m_programId);
 }
+Shader::Uniform Shader::GetUniform(const std::string& name) const
+{
+	std::unordered_map<std::string, GLint>::const_iterator found = m_uniforms.find(name);
+	return found == m_uniforms.end() ? Uniform() : Uniform(found->second);
+}
 void Shader::SetMat4(const std::string& name, const glm::mat4& mat) const
 {
-	glUniformMatrix4fv(glGetUniformLocation(m_programId, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+	SetMat4(GetUniform(name), mat);
 }
 void Shader::SetVec3(const std::string& name, const glm::vec3& value) const
 {
-	glUniform3fv(glGetUniformLocation(m_programId, name.c_str()), 1, &value[0]);
+	SetVec3(GetUniform(name), value);
 }
 void Shader::SetFloat(const std::string& name, float value) const
 {
-	glUniform1f(glGetUniformLocation(m_programId, name.c_str()), value);
+	SetFloat(GetUniform(name), value);
 }
 void Shader::SetInt(const std::string& name, int value) const
 {
-	glUniform1i(glGetUniformLocation(m_programId, name.c_str()), value);
+	SetInt(GetUniform(name), value);
 }
 void Shader::SetBool(const std::string& name, bool value) const
 {
-	glUniform1i(glGetUniformLocation(m_programId, name.c_str()), value);
-}
\ No newline at end of file
+	SetBool(GetUniform(name), value);
+}
+void Shader::SetMat4(Uniform uniform, const glm::mat4& mat) const
+{
+	glUniformMatrix4fv(uniform.location, 1, GL_FALSE, &mat[0][0]);
+}
+void Shader::SetVec3(Uniform uniform, const glm::vec3& value) const
+{
+	glUniform3fv(uniform.location, 1, &value[0]);
+}
+void Shader::SetFloat(Uniform uniform, float value) const
+{
+	glUniform1f(uniform.location, value);
+}
+void Shader::SetInt(Uniform uniform, int value) const
+{
+	glUniform1i(uniform.location, value);
+}
+void Shader::SetBool(Uniform uniform, bool value) const
+{
+	glUniform1i(uniform.location, value);
+}
+void Shader::SetVec3Array(Uniform uniform, const glm::vec3* values, int count) const
+{
+	glUniform3fv(uniform.location, count, &values[0][0]);
+}
@@ -14,6 +14,7 @@ End Header --------------------------------------------------------*/
 #include "glad/glad.h"
 #include "glm/glm.hpp"
 #include <string>
+#include <unordered_map>
 
 class Shader {
 public:
@@ -30,11 +31,25 @@ public:
 		S_LIGHT,
 	};
 
+	// location resolved once, a uniform the program doesn't have stays -1 and setting it does nothing
+	struct Uniform {
+		GLint location;
+		Uniform() : location(-1) {}
+		explicit Uniform(GLint location_) : location(location_) {}
+	};
+	// what every Object draw sets, and the material the scene sets between draws, resolved when the program
+	// links. view and projection are in the frame block
+	struct CommonUniforms {
+		Uniform model, octahedral_normals, instanced, instance_material, material;
+	};
+
 	Shader() : m_programId(0), m_vertexId(0), m_fragmentId(0), m_geometryId(0), m_infoLogLength(0), m_result(0){};
 	~Shader();
 
 	void CreateShader(const char* vertex_file_path, const char* fragment_file_path,
 		const char* geometry_file_path);
+	// single compute stage program, run with Use() and glDispatchCompute
+	void CreateComputeShader(const char* compute_file_path);
 
 	void Use() const;
 
@@ -44,7 +59,30 @@ public:
 	void SetInt(const std::string& name, int value) const;
 	void SetBool(const std::string& name, bool value) const;
 
+	// name, or name[i] for one element of an array, looked up in the table built at link time
+	Uniform GetUniform(const std::string& name) const;
+	const CommonUniforms& Common() const { return m_common; }
+
+	void SetVec3(Uniform uniform, const glm::vec3& value) const;
+	void SetMat4(Uniform uniform, const glm::mat4& mat) const;
+	void SetFloat(Uniform uniform, float value) const;
+	void SetInt(Uniform uniform, int value) const;
+	void SetBool(Uniform uniform, bool value) const;
+	// count elements of a uniform array from the one uniform points at
+	void SetVec3Array(Uniform uniform, const glm::vec3* values, int count) const;
+
 private:
+	// the whole file at path, false and a message when it can't be opened
+	static bool ReadSource(const char* path, std::string& source);
+	// a new shader object of type compiled from source, its info log printed against path when that fails
+	GLuint CompileStage(GLenum type, const std::string& source, const char* path);
+	// links the compiled stages into a new m_programId and reflects its uniforms
+	void LinkProgram(const GLuint* stages, unsigned count, const char* path);
+	// binds the shared uniform blocks, then every active uniform and every element of the active arrays by name
+	void ReflectUniforms();
+
+	std::unordered_map<std::string, GLint> m_uniforms;
+	CommonUniforms m_common;
 	static std::string m_vertexShader, m_fragmentShader, m_geometryShader;
 	GLuint m_programId, m_vertexId, m_fragmentId, m_geometryId;
 	int m_infoLogLength;
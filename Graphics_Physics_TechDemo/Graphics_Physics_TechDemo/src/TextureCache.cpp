@@ -0,0 +1,499 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: TextureCache.cpp
+Purpose: Versioned cache of a block compressed image with its mip chain, mapped and uploaded as is
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#include "glad/glad.h"
+#include "TextureCache.h"
+#include "FileUtil.h"
+#include "..\include\stb_image.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define TEXTURE_CACHE_MAGIC "GPTX"
+
+static_assert(sizeof(TextureCacheHeader) % 8 == 0, "levels follow the header aligned");
+
+namespace
+{
+	size_t BlockBytes(unsigned format)
+	{
+		return format == GL_COMPRESSED_RG_RGTC2 || format == GL_COMPRESSED_RGBA_BPTC_UNORM ? 16 : 8;
+	}
+
+	size_t CacheSize(const TextureCacheHeader& header)
+	{
+		size_t size = sizeof(TextureCacheHeader);
+		for (unsigned level = 0; level < header.levels; ++level)
+			size += TextureCache::LevelSize(header.format, std::max(header.width >> level, 1u), std::max(header.height >> level, 1u));
+		return size;
+	}
+
+	// BC4: two 8 bit endpoints, hi first for the 8 value mode, and a 3 bit index per texel
+	void EncodeBC4(const unsigned char values[16], unsigned char* block)
+	{
+		int lo = 255, hi = 0;
+		for (int i = 0; i < 16; ++i)
+		{
+			lo = std::min(lo, static_cast<int>(values[i]));
+			hi = std::max(hi, static_cast<int>(values[i]));
+		}
+		block[0] = static_cast<unsigned char>(hi);
+		block[1] = static_cast<unsigned char>(lo);
+		int palette[8] = { hi, lo };
+		for (int i = 2; i < 8; ++i)
+			palette[i] = ((8 - i) * hi + (i - 1) * lo) / 7;
+
+		unsigned long long indices = 0;
+		if (hi != lo)
+			for (int i = 0; i < 16; ++i)
+			{
+				int best = 0, best_error = 256;
+				for (int p = 0; p < 8; ++p)
+				{
+					int error = abs(values[i] - palette[p]);
+					if (error < best_error)
+					{
+						best_error = error;
+						best = p;
+					}
+				}
+				indices |= static_cast<unsigned long long>(best) << (3 * i);
+			}
+		for (int i = 0; i < 6; ++i)
+			block[2 + i] = static_cast<unsigned char>(indices >> (8 * i));
+	}
+
+	unsigned short To565(const unsigned char* rgb)
+	{
+		return static_cast<unsigned short>(((rgb[0] * 31 + 127) / 255) << 11 | ((rgb[1] * 63 + 127) / 255) << 5 | ((rgb[2] * 31 + 127) / 255));
+	}
+	void From565(unsigned short color, int rgb[3])
+	{
+		int r = color >> 11, g = (color >> 5) & 63, b = color & 31;
+		rgb[0] = (r << 3) | (r >> 2);
+		rgb[1] = (g << 2) | (g >> 4);
+		rgb[2] = (b << 3) | (b >> 2);
+	}
+
+	// the texels furthest apart along the block's principal axis
+	void PrincipalExtremes(const unsigned char texels[16][3], int& lo, int& hi)
+	{
+		float mean[3] = { 0.f, 0.f, 0.f };
+		for (int i = 0; i < 16; ++i)
+			for (int c = 0; c < 3; ++c)
+				mean[c] += texels[i][c] / 16.f;
+		float cov[3][3] = {};
+		for (int i = 0; i < 16; ++i)
+		{
+			float d[3] = { texels[i][0] - mean[0], texels[i][1] - mean[1], texels[i][2] - mean[2] };
+			for (int a = 0; a < 3; ++a)
+				for (int b = 0; b < 3; ++b)
+					cov[a][b] += d[a] * d[b];
+		}
+		float axis[3] = { 1.f, 1.f, 1.f };
+		for (int iteration = 0; iteration < 8; ++iteration)
+		{
+			float next[3];
+			for (int a = 0; a < 3; ++a)
+				next[a] = cov[a][0] * axis[0] + cov[a][1] * axis[1] + cov[a][2] * axis[2];
+			float length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2]);
+			if (length < 1e-6f)
+				break;
+			for (int a = 0; a < 3; ++a)
+				axis[a] = next[a] / length;
+		}
+		lo = hi = 0;
+		float lo_dot = 1e30f, hi_dot = -1e30f;
+		for (int i = 0; i < 16; ++i)
+		{
+			float dot = texels[i][0] * axis[0] + texels[i][1] * axis[1] + texels[i][2] * axis[2];
+			if (dot < lo_dot)
+			{
+				lo_dot = dot;
+				lo = i;
+			}
+			if (dot > hi_dot)
+			{
+				hi_dot = dot;
+				hi = i;
+			}
+		}
+	}
+
+	// BC1: the principal axis extremes as 565 endpoints, 2 bit indices
+	void EncodeBC1(const unsigned char texels[16][3], unsigned char* block)
+	{
+		int lo, hi;
+		PrincipalExtremes(texels, lo, hi);
+		unsigned short c0 = To565(texels[hi]), c1 = To565(texels[lo]);
+		// c0 > c1 selects the 4 color mode
+		if (c0 < c1)
+			std::swap(c0, c1);
+		block[0] = static_cast<unsigned char>(c0);
+		block[1] = static_cast<unsigned char>(c0 >> 8);
+		block[2] = static_cast<unsigned char>(c1);
+		block[3] = static_cast<unsigned char>(c1 >> 8);
+
+		unsigned indices = 0;
+		if (c0 != c1)
+		{
+			int palette[4][3];
+			From565(c0, palette[0]);
+			From565(c1, palette[1]);
+			for (int c = 0; c < 3; ++c)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+			for (int i = 0; i < 16; ++i)
+			{
+				int best = 0, best_error = 0x7fffffff;
+				for (int p = 0; p < 4; ++p)
+				{
+					int dr = texels[i][0] - palette[p][0], dg = texels[i][1] - palette[p][1], db = texels[i][2] - palette[p][2];
+					int error = dr * dr + dg * dg + db * db;
+					if (error < best_error)
+					{
+						best_error = error;
+						best = p;
+					}
+				}
+				indices |= static_cast<unsigned>(best) << (2 * i);
+			}
+		}
+		for (int i = 0; i < 4; ++i)
+			block[4 + i] = static_cast<unsigned char>(indices >> (8 * i));
+	}
+
+	// BC7 mode 6: one subset, 7 bit rgba endpoints with a low p bit each and 4 bit indices. Unlike BC1
+	// the channels keep their own precision, which packed maps need. Both p bits are set so alpha is 255
+	void EncodeBC7(const unsigned char texels[16][3], unsigned char* block)
+	{
+		static const int weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+		int lo, hi;
+		PrincipalExtremes(texels, lo, hi);
+		int endpoints[2][3];
+		for (int c = 0; c < 3; ++c)
+		{
+			endpoints[0][c] = texels[lo][c] | 1;
+			endpoints[1][c] = texels[hi][c] | 1;
+		}
+		int palette[16][3];
+		for (int p = 0; p < 16; ++p)
+			for (int c = 0; c < 3; ++c)
+				palette[p][c] = ((64 - weights[p]) * endpoints[0][c] + weights[p] * endpoints[1][c] + 32) >> 6;
+		int indices[16];
+		for (int i = 0; i < 16; ++i)
+		{
+			int best_error = 0x7fffffff;
+			for (int p = 0; p < 16; ++p)
+			{
+				int dr = texels[i][0] - palette[p][0], dg = texels[i][1] - palette[p][1], db = texels[i][2] - palette[p][2];
+				int error = dr * dr + dg * dg + db * db;
+				if (error < best_error)
+				{
+					best_error = error;
+					indices[i] = p;
+				}
+			}
+		}
+		// the first index is stored without its top bit, so it has to be below 8
+		if (indices[0] >= 8)
+		{
+			for (int c = 0; c < 3; ++c)
+				std::swap(endpoints[0][c], endpoints[1][c]);
+			for (int i = 0; i < 16; ++i)
+				indices[i] = 15 - indices[i];
+		}
+
+		memset(block, 0, 16);
+		unsigned position = 0;
+		auto put = [&](unsigned value, unsigned count) {
+			for (unsigned bit = 0; bit < count; ++bit, ++position)
+				if ((value >> bit) & 1)
+					block[position / 8] |= static_cast<unsigned char>(1 << (position % 8));
+		};
+		put(1 << 6, 7);
+		for (int c = 0; c < 3; ++c)
+		{
+			put(endpoints[0][c] >> 1, 7);
+			put(endpoints[1][c] >> 1, 7);
+		}
+		put(127, 7);
+		put(127, 7);
+		put(1, 1);
+		put(1, 1);
+		put(indices[0], 3);
+		for (int i = 1; i < 16; ++i)
+			put(indices[i], 4);
+	}
+
+	// red of each source into its own channel at the size of the largest, bilinear for a smaller one.
+	// A source that doesn't decode leaves its channel 0, false only when none does
+	bool PackChannels(const TextureCache::Sources& sources, unsigned& width, unsigned& height, std::vector<unsigned char>& rgb)
+	{
+		struct Channel {
+			unsigned char* data;
+			int width, height, stride;
+		} channels[3] = {};
+		width = height = 0;
+		for (size_t c = 0; c < sources.size() && c < 3; ++c)
+		{
+			// as stored, the first component is red or grey
+			channels[c].data = stbi_load(sources[c].c_str(), &channels[c].width, &channels[c].height, &channels[c].stride, 0);
+			if (!channels[c].data)
+				continue;
+			width = std::max(width, static_cast<unsigned>(channels[c].width));
+			height = std::max(height, static_cast<unsigned>(channels[c].height));
+		}
+		if (!width)
+			return false;
+
+		rgb.assign(static_cast<size_t>(width) * height * 3, 0);
+		for (unsigned c = 0; c < 3; ++c)
+		{
+			const Channel& channel = channels[c];
+			if (!channel.data)
+				continue;
+			float scale_x = static_cast<float>(channel.width) / width, scale_y = static_cast<float>(channel.height) / height;
+			for (unsigned y = 0; y < height; ++y)
+			{
+				float sy = std::max((y + 0.5f) * scale_y - 0.5f, 0.f);
+				int y0 = std::min(static_cast<int>(sy), channel.height - 1), y1 = std::min(y0 + 1, channel.height - 1);
+				float fy = sy - y0;
+				for (unsigned x = 0; x < width; ++x)
+				{
+					float sx = std::max((x + 0.5f) * scale_x - 0.5f, 0.f);
+					int x0 = std::min(static_cast<int>(sx), channel.width - 1), x1 = std::min(x0 + 1, channel.width - 1);
+					float fx = sx - x0;
+					const unsigned char* row0 = channel.data + static_cast<size_t>(y0) * channel.width * channel.stride;
+					const unsigned char* row1 = channel.data + static_cast<size_t>(y1) * channel.width * channel.stride;
+					float top = row0[x0 * channel.stride] * (1.f - fx) + row0[x1 * channel.stride] * fx;
+					float bottom = row1[x0 * channel.stride] * (1.f - fx) + row1[x1 * channel.stride] * fx;
+					float value = top * (1.f - fy) + bottom * fy;
+					rgb[(static_cast<size_t>(y) * width + x) * 3 + c] = static_cast<unsigned char>(value + 0.5f);
+				}
+			}
+			stbi_image_free(channel.data);
+		}
+		return true;
+	}
+
+	// 2x2 box filter, an odd last row or column is averaged with itself
+	void Downsample(const std::vector<unsigned char>& src, unsigned width, unsigned height, std::vector<unsigned char>& dst)
+	{
+		unsigned dst_width = std::max(width / 2, 1u), dst_height = std::max(height / 2, 1u);
+		dst.resize(static_cast<size_t>(dst_width) * dst_height * 3);
+		for (unsigned y = 0; y < dst_height; ++y)
+		{
+			size_t y0 = std::min(2 * y, height - 1), y1 = std::min(2 * y + 1, height - 1);
+			for (unsigned x = 0; x < dst_width; ++x)
+			{
+				size_t x0 = std::min(2 * x, width - 1), x1 = std::min(2 * x + 1, width - 1);
+				for (unsigned c = 0; c < 3; ++c)
+				{
+					unsigned sum = src[(y0 * width + x0) * 3 + c] + src[(y0 * width + x1) * 3 + c]
+						+ src[(y1 * width + x0) * 3 + c] + src[(y1 * width + x1) * 3 + c];
+					dst[(static_cast<size_t>(y) * dst_width + x) * 3 + c] = static_cast<unsigned char>((sum + 2) / 4);
+				}
+			}
+		}
+	}
+}
+
+std::string TextureCache::CachePath(const char* source)
+{
+	return std::string(source) + TEXTURE_CACHE_EXTENSION;
+}
+bool TextureCache::Compressed(unsigned format)
+{
+	return format != GL_RGB8;
+}
+unsigned TextureCache::LevelCount(unsigned width, unsigned height)
+{
+	unsigned levels = 1;
+	while ((std::max(width, height) >> levels) > 0)
+		++levels;
+	return levels;
+}
+size_t TextureCache::LevelSize(unsigned format, unsigned width, unsigned height)
+{
+	if (!Compressed(format))
+		return static_cast<size_t>(width) * height * 3;
+	return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * BlockBytes(format);
+}
+void TextureCache::Encode(unsigned format, const unsigned char* rgb, unsigned width, unsigned height, unsigned char* out)
+{
+	if (!Compressed(format))
+	{
+		memcpy(out, rgb, static_cast<size_t>(width) * height * 3);
+		return;
+	}
+	size_t block_bytes = BlockBytes(format);
+	for (unsigned by = 0; by < height; by += 4)
+		for (unsigned bx = 0; bx < width; bx += 4)
+		{
+			unsigned char texels[16][3];
+			unsigned char red[16], green[16];
+			for (unsigned y = 0; y < 4; ++y)
+				for (unsigned x = 0; x < 4; ++x)
+				{
+					const unsigned char* texel = rgb + (static_cast<size_t>(std::min(by + y, height - 1)) * width + std::min(bx + x, width - 1)) * 3;
+					unsigned i = y * 4 + x;
+					memcpy(texels[i], texel, 3);
+					red[i] = texel[0];
+					green[i] = texel[1];
+				}
+			if (format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT)
+				EncodeBC1(texels, out);
+			else if (format == GL_COMPRESSED_RGBA_BPTC_UNORM)
+				EncodeBC7(texels, out);
+			else if (format == GL_COMPRESSED_RG_RGTC2)
+			{
+				EncodeBC4(red, out);
+				EncodeBC4(green, out + 8);
+			}
+			else
+				EncodeBC4(red, out);
+			out += block_bytes;
+		}
+}
+void TextureCache::Fill(unsigned format, unsigned width, unsigned height, const unsigned char color[3], std::vector<unsigned char>& out)
+{
+	unsigned char texels[16 * 3];
+	for (unsigned i = 0; i < 16; ++i)
+		memcpy(texels + i * 3, color, 3);
+	// one block, or one texel for GL_RGB8, repeated
+	unsigned char unit[16];
+	size_t unit_size = Compressed(format) ? BlockBytes(format) : 3;
+	Encode(format, texels, Compressed(format) ? 4 : 1, Compressed(format) ? 4 : 1, unit);
+	out.resize(LevelSize(format, width, height));
+	for (size_t offset = 0; offset < out.size(); offset += unit_size)
+		memcpy(&out[offset], unit, unit_size);
+}
+
+bool TextureCache::Open(const std::string& path, const Sources& sources, unsigned format)
+{
+	Close();
+	unsigned long long size;
+	long long mtime;
+	if (!StampSources(sources, size, mtime) || !m_file.Open(path.c_str()))
+		return false;
+
+	bool valid = m_file.size() >= sizeof(TextureCacheHeader), touched = false;
+	if (valid)
+	{
+		const TextureCacheHeader& h = header();
+		valid = !memcmp(h.magic, TEXTURE_CACHE_MAGIC, sizeof(h.magic)) && h.version == TEXTURE_CACHE_VERSION
+			&& h.format == format && h.width && h.height && h.levels == LevelCount(h.width, h.height)
+			&& m_file.size() == CacheSize(h) && h.source_size == size;
+		// a touched but unchanged image (checkout, copy) still matches by content
+		unsigned long long hash;
+		touched = valid && h.source_mtime != mtime;
+		if (touched)
+			valid = HashSources(sources, hash) && hash == h.source_hash;
+	}
+	if (!valid)
+	{
+		Close();
+		return false;
+	}
+	if (touched)
+	{
+		// take the new mtime so only the first load after the touch hashes the images
+		size_t expected = m_file.size();
+		Close();
+		RestampCache(path.c_str(), offsetof(TextureCacheHeader, source_mtime), mtime);
+		if (!m_file.Open(path.c_str()) || m_file.size() != expected)
+		{
+			Close();
+			return false;
+		}
+	}
+	return true;
+}
+bool TextureCache::Build(const std::string& path, const Sources& sources, unsigned format)
+{
+	Close();
+	unsigned width, height;
+	std::vector<unsigned char> level, next;
+	if (sources.size() == 1)
+	{
+		int image_width, image_height, nrChannels;
+		// greyscale comes in replicated, so red is the value for every format
+		unsigned char* data = stbi_load(sources[0].c_str(), &image_width, &image_height, &nrChannels, 3);
+		if (!data)
+			return false;
+		width = static_cast<unsigned>(image_width);
+		height = static_cast<unsigned>(image_height);
+		level.assign(data, data + static_cast<size_t>(width) * height * 3);
+		stbi_image_free(data);
+	}
+	else if (!PackChannels(sources, width, height, level))
+		return false;
+
+	TextureCacheHeader header = {};
+	memcpy(header.magic, TEXTURE_CACHE_MAGIC, sizeof(header.magic));
+	header.version = TEXTURE_CACHE_VERSION;
+	// without a stamp the cache is still used this run, the next Open just won't match it
+	if (!StampSources(sources, header.source_size, header.source_mtime) || !HashSources(sources, header.source_hash))
+		header.source_size = ~0ull;
+	header.format = format;
+	header.width = width;
+	header.height = height;
+	header.levels = LevelCount(header.width, header.height);
+
+	m_built.resize(CacheSize(header));
+	memcpy(&m_built[0], &header, sizeof(header));
+	unsigned char* out = &m_built[sizeof(header)];
+	unsigned level_width = header.width, level_height = header.height;
+	for (unsigned l = 0; l < header.levels; ++l)
+	{
+		Encode(format, &level[0], level_width, level_height, out);
+		out += LevelSize(format, level_width, level_height);
+		if (l + 1 < header.levels)
+		{
+			Downsample(level, level_width, level_height, next);
+			level.swap(next);
+			level_width = std::max(level_width / 2, 1u);
+			level_height = std::max(level_height / 2, 1u);
+		}
+	}
+
+	FILE* file = fopen(path.c_str(), "wb");
+	if (file)
+	{
+		bool written = fwrite(&m_built[0], m_built.size(), 1, file) == 1;
+		written = fclose(file) == 0 && written;
+		// a partial file would fail the size check anyway, don't leave it around
+		if (!written)
+			remove(path.c_str());
+	}
+	return true;
+}
+void TextureCache::Close()
+{
+	m_file.Close();
+	std::vector<unsigned char>().swap(m_built);
+}
+size_t TextureCache::levels_size() const
+{
+	return CacheSize(header()) - sizeof(TextureCacheHeader);
+}
+const unsigned char* TextureCache::bytes() const
+{
+	return m_built.empty() ? reinterpret_cast<const unsigned char*>(m_file.data()) : &m_built[0];
+}
@@ -0,0 +1,78 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: TextureCache.h
+Purpose: Versioned cache of a block compressed image with its mip chain, mapped and uploaded as is
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#pragma once
+
+#ifndef TEXTURECACHE_H
+#define TEXTURECACHE_H
+
+#include "FileUtil.h"
+#include <string>
+#include <vector>
+
+// bump whenever TextureCacheHeader, the block encoders or the mip filter change
+#define TEXTURE_CACHE_VERSION 2
+// written next to the image, ao.png -> ao.png.tex. Packed maps name their own
+#define TEXTURE_CACHE_EXTENSION ".tex"
+
+// file layout: header, then every level from the largest down, LevelSize bytes each
+struct TextureCacheHeader {
+	char magic[4];
+	unsigned version;
+	// the images the cache was built from: summed sizes, latest mtime and their hashes folded together.
+	// The hash is only checked when the mtime differs
+	unsigned long long source_size;
+	long long source_mtime;
+	unsigned long long source_hash;
+	// GL_COMPRESSED_RGB_S3TC_DXT1_EXT (BC1) or GL_COMPRESSED_RGBA_BPTC_UNORM (BC7) from rgb,
+	// GL_COMPRESSED_RG_RGTC2 (BC5) from red and green, GL_COMPRESSED_RED_RGTC1 (BC4) from red, or plain GL_RGB8
+	unsigned format;
+	unsigned width;
+	unsigned height;
+	unsigned levels;
+	unsigned reserved[2];
+};
+
+class TextureCache {
+public:
+	// one image, or up to three whose red channels are packed into r, g and b
+	typedef std::vector<std::string> Sources;
+
+	static std::string CachePath(const char* source);
+	static bool Compressed(unsigned format);
+	// full chain down to 1x1
+	static unsigned LevelCount(unsigned width, unsigned height);
+	static size_t LevelSize(unsigned format, unsigned width, unsigned height);
+	// one level of rgb texels into format, edges repeated for levels smaller than a block
+	static void Encode(unsigned format, const unsigned char* rgb, unsigned width, unsigned height, unsigned char* out);
+	// a width x height image of one color in format, every smaller level is a prefix of it
+	static void Fill(unsigned format, unsigned width, unsigned height, const unsigned char color[3], std::vector<unsigned char>& out);
+
+	// map the cache at path, false when it is missing, truncated, another version or format, or stale
+	bool Open(const std::string& path, const Sources& sources, unsigned format);
+	// decode or pack sources, box filter the mip chain, encode every level in format and write path.
+	// The result stays readable when the file can't be written, false only if no source decodes
+	bool Build(const std::string& path, const Sources& sources, unsigned format);
+	void Close();
+
+	const TextureCacheHeader& header() const { return *reinterpret_cast<const TextureCacheHeader*>(bytes()); }
+	// every level back to back, largest first
+	const unsigned char* levels() const { return bytes() + sizeof(TextureCacheHeader); }
+	size_t levels_size() const;
+private:
+	const unsigned char* bytes() const;
+
+	MappedFile m_file;
+	std::vector<unsigned char> m_built;
+};
+
+#endif
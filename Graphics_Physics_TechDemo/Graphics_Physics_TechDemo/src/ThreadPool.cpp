@@ -0,0 +1,110 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: ThreadPool.cpp
+Purpose: Fixed size worker pool, parallel for over index ranges
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#include "ThreadPool.h"
+
+namespace
+{
+	thread_local bool inside_job = false;
+	ThreadPool* instance = nullptr;
+}
+
+ThreadPool::ThreadPool(unsigned threads)
+	: m_job(nullptr), m_count(0), m_grain(1), m_next(0), m_active(0), m_generation(0), m_quit(false)
+{
+	for (unsigned i = 1; i < threads; ++i)
+		m_workers.push_back(std::thread(&ThreadPool::WorkerLoop, this));
+}
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_quit = true;
+	}
+	m_wake.notify_all();
+	for (auto& worker : m_workers)
+		worker.join();
+}
+ThreadPool& ThreadPool::Instance()
+{
+	if (instance)
+		return *instance;
+	static ThreadPool pool(std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1);
+	return pool;
+}
+void ThreadPool::SetInstance(ThreadPool* pool)
+{
+	instance = pool;
+}
+void ThreadPool::ParallelFor(unsigned count, unsigned grain, const RangeJob& job)
+{
+	if (grain == 0)
+		grain = 1;
+	if (count == 0)
+		return;
+	if (inside_job || m_workers.empty() || count <= grain)
+	{
+		job(0, count);
+		return;
+	}
+
+	std::lock_guard<std::mutex> dispatch(m_dispatch);
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_job = &job;
+		m_count = count;
+		m_grain = grain;
+		m_next = 0;
+		m_active = static_cast<unsigned>(m_workers.size());
+		++m_generation;
+	}
+	m_wake.notify_all();
+
+	RunChunks();
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_done.wait(lock, [this] { return m_active == 0; });
+	m_job = nullptr;
+}
+void ThreadPool::WorkerLoop()
+{
+	unsigned seen = 0;
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wake.wait(lock, [this, seen] { return m_quit || m_generation != seen; });
+			if (m_quit)
+				return;
+			seen = m_generation;
+		}
+		RunChunks();
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			--m_active;
+		}
+		m_done.notify_one();
+	}
+}
+void ThreadPool::RunChunks()
+{
+	inside_job = true;
+	for (;;)
+	{
+		unsigned begin = m_next.fetch_add(m_grain);
+		if (begin >= m_count)
+			break;
+		unsigned end = begin + m_grain < m_count ? begin + m_grain : m_count;
+		(*m_job)(begin, end);
+	}
+	inside_job = false;
+}
@@ -0,0 +1,61 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: ThreadPool.h
+Purpose: Prototype of fixed size worker pool used by the physics
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#pragma once
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+class ThreadPool {
+public:
+	typedef std::function<void(unsigned begin, unsigned end)> RangeJob;
+
+	explicit ThreadPool(unsigned threads);
+	~ThreadPool();
+
+	// shared pool sized to the hardware, created on first use, or the pool given to SetInstance
+	static ThreadPool& Instance();
+	// route Instance to pool, nullptr goes back to the shared one. Only while no job is running
+	static void SetInstance(ThreadPool* pool);
+
+	// split [0, count) into chunks of at least grain items and run them on the workers and the caller.
+	// Returns when every chunk is done. Calls made from inside a job run inline on the calling thread.
+	void ParallelFor(unsigned count, unsigned grain, const RangeJob& job);
+
+	unsigned size() const { return static_cast<unsigned>(m_workers.size()) + 1; }
+private:
+	void WorkerLoop();
+	void RunChunks();
+
+	std::vector<std::thread> m_workers;
+	std::mutex m_dispatch;
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_done;
+
+	const RangeJob* m_job;
+	unsigned m_count;
+	unsigned m_grain;
+	std::atomic<unsigned> m_next;
+	unsigned m_active;
+	unsigned m_generation;
+	bool m_quit;
+};
+
+#endif
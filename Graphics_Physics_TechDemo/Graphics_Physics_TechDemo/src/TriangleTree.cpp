@@ -0,0 +1,140 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: TriangleTree.cpp
+Purpose: Median split build, bottom up refit and box query of the triangle tree
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#include "TriangleTree.h"
+#include <algorithm>
+
+void TriangleTree::Build(const ParticleArray& pos, const std::vector<unsigned>& indices, unsigned triangles, float margin)
+{
+	m_margin = margin;
+	m_corner.resize(3 * triangles);
+	m_normal.resize(triangles);
+	m_d.resize(triangles);
+	m_order.resize(triangles);
+	m_nodes.clear();
+
+	std::vector<glm::vec3> centroid(triangles);
+	for (unsigned t = 0; t < triangles; ++t)
+	{
+		m_corner[3 * t] = indices[3 * t];
+		m_corner[3 * t + 1] = indices[3 * t + 2];
+		m_corner[3 * t + 2] = indices[3 * t + 1];
+		centroid[t] = (pos.get(m_corner[3 * t]) + pos.get(m_corner[3 * t + 1]) + pos.get(m_corner[3 * t + 2])) / 3.f;
+		m_order[t] = t;
+	}
+	if (triangles == 0)
+		return;
+
+	m_nodes.reserve(2 * triangles / TREE_LEAF_SIZE + 1);
+	BuildNode(centroid, 0, triangles);
+	Refit(pos);
+}
+
+int TriangleTree::BuildNode(std::vector<glm::vec3>& centroid, unsigned first, unsigned count)
+{
+	int index = static_cast<int>(m_nodes.size());
+	Node node;
+	node.left = node.right = -1;
+	node.first = first;
+	node.count = count;
+	m_nodes.push_back(node);
+	if (count <= TREE_LEAF_SIZE)
+		return index;
+
+	// split at the median along the longest axis of the centroids
+	glm::vec3 min = centroid[m_order[first]], max = min;
+	for (unsigned k = first; k < first + count; ++k)
+	{
+		min = glm::min(min, centroid[m_order[k]]);
+		max = glm::max(max, centroid[m_order[k]]);
+	}
+	glm::vec3 extent = max - min;
+	int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+
+	unsigned half = count / 2;
+	std::nth_element(m_order.begin() + first, m_order.begin() + first + half, m_order.begin() + first + count,
+		[&centroid, axis](unsigned a, unsigned b) { return centroid[a][axis] < centroid[b][axis]; });
+
+	// children always come after their parent, Refit relies on it
+	int left = BuildNode(centroid, first, half);
+	int right = BuildNode(centroid, first + half, count - half);
+	m_nodes[index].left = left;
+	m_nodes[index].right = right;
+	return index;
+}
+
+void TriangleTree::Refit(const ParticleArray& pos)
+{
+	unsigned triangles = size();
+	for (unsigned t = 0; t < triangles; ++t)
+	{
+		glm::vec3 point0 = pos.get(m_corner[3 * t]);
+		glm::vec3 point1 = pos.get(m_corner[3 * t + 1]);
+		glm::vec3 point2 = pos.get(m_corner[3 * t + 2]);
+
+		glm::vec3 v = point1 - point0;
+		glm::vec3 w = point2 - point0;
+		m_normal[t] = glm::normalize(glm::cross(v, w));
+		m_d[t] = -glm::dot(m_normal[t], point0);
+	}
+
+	for (int n = static_cast<int>(m_nodes.size()) - 1; n >= 0; --n)
+	{
+		Node& node = m_nodes[n];
+		if (node.left >= 0)
+		{
+			node.min = glm::min(m_nodes[node.left].min, m_nodes[node.right].min);
+			node.max = glm::max(m_nodes[node.left].max, m_nodes[node.right].max);
+			continue;
+		}
+		// the contact test only looks at the box of point0 and point1
+		unsigned t = m_order[node.first];
+		node.min = glm::min(pos.get(corner0(t)), pos.get(corner1(t)));
+		node.max = glm::max(pos.get(corner0(t)), pos.get(corner1(t)));
+		for (unsigned k = node.first + 1; k < node.first + node.count; ++k)
+		{
+			t = m_order[k];
+			node.min = glm::min(node.min, glm::min(pos.get(corner0(t)), pos.get(corner1(t))));
+			node.max = glm::max(node.max, glm::max(pos.get(corner0(t)), pos.get(corner1(t))));
+		}
+		node.min -= glm::vec3(m_margin);
+		node.max += glm::vec3(m_margin);
+	}
+}
+
+void TriangleTree::Query(const glm::vec3& min, const glm::vec3& max, std::vector<unsigned>& hits) const
+{
+	hits.clear();
+	if (m_nodes.empty())
+		return;
+
+	int stack[64];
+	int top = 0;
+	stack[top++] = 0;
+	while (top)
+	{
+		const Node& node = m_nodes[stack[--top]];
+		if (max.x < node.min.x || min.x > node.max.x
+			|| max.y < node.min.y || min.y > node.max.y
+			|| max.z < node.min.z || min.z > node.max.z)
+			continue;
+		if (node.left < 0)
+		{
+			for (unsigned k = node.first; k < node.first + node.count; ++k)
+				hits.push_back(m_order[k]);
+			continue;
+		}
+		stack[top++] = node.left;
+		stack[top++] = node.right;
+	}
+	std::sort(hits.begin(), hits.end());
+}
@@ -0,0 +1,60 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: TriangleTree.h
+Purpose: Prototype of refittable AABB tree over a softbody's triangles
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#pragma once
+
+#ifndef TRIANGLE_TREE_H
+#define TRIANGLE_TREE_H
+
+#include "Particle.h"
+#include <vector>
+
+#define TREE_LEAF_SIZE 4
+
+class TriangleTree {
+public:
+	// triangle t uses indices[3t], indices[3t+2], indices[3t+1] as point0 / point1 / point2 like CollisionResponseSoft.
+	// Topology is fixed here, later steps only refit the boxes.
+	void Build(const ParticleArray& pos, const std::vector<unsigned>& indices, unsigned triangles, float margin);
+	// recompute planes and boxes bottom up from the current particle positions
+	void Refit(const ParticleArray& pos);
+	// ascending ids of the triangles whose box overlaps [min, max]
+	void Query(const glm::vec3& min, const glm::vec3& max, std::vector<unsigned>& hits) const;
+
+	bool empty() const { return m_nodes.empty(); }
+	unsigned size() const { return static_cast<unsigned>(m_normal.size()); }
+
+	// particle index of point0 / point1 of triangle t
+	unsigned corner0(unsigned t) const { return m_corner[3 * t]; }
+	unsigned corner1(unsigned t) const { return m_corner[3 * t + 1]; }
+	const glm::vec3& normal(unsigned t) const { return m_normal[t]; }
+	float d(unsigned t) const { return m_d[t]; }
+private:
+	struct Node {
+		glm::vec3 min;
+		glm::vec3 max;
+		int left;			// -1 for a leaf
+		int right;
+		unsigned first;		// leaf range in m_order
+		unsigned count;
+	};
+	int BuildNode(std::vector<glm::vec3>& centroid, unsigned first, unsigned count);
+
+	std::vector<Node> m_nodes;
+	std::vector<unsigned> m_order;
+	std::vector<unsigned> m_corner;
+	std::vector<glm::vec3> m_normal;
+	std::vector<float> m_d;
+	float m_margin;
+};
+
+#endif
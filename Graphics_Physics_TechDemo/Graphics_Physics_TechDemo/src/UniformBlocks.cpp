@@ -0,0 +1,97 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: UniformBlocks.cpp
+Purpose: std140 uniform buffers for the camera, lights and material shared by the scene shaders
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#include "glad/glad.h"
+#include "UniformBlocks.h"
+#include "Camera.h"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+static_assert(sizeof(FrameBlock) == 144, "FrameBlock is uploaded as its std140 layout");
+static_assert(offsetof(LightsBlock, count) == 2 * MAX_BLOCK_LIGHTS * 16, "vec3 arrays have a 16 byte stride in std140");
+static_assert(sizeof(MaterialBlock) == 16, "MaterialBlock is uploaded as its std140 layout");
+
+UniformBlocks::UniformBlocks() : m_frame(0), m_lights(0), m_material(0)
+{
+}
+UniformBlocks::~UniformBlocks()
+{
+	Shutdown();
+}
+void UniformBlocks::Init()
+{
+	if (m_frame)
+		return;
+	glGenBuffers(1, &m_frame);
+	glGenBuffers(1, &m_lights);
+	glGenBuffers(1, &m_material);
+
+	// zeroed so shaders see no lights and no material override until the first update
+	FrameBlock frame = {};
+	LightsBlock lights = {};
+	MaterialBlock material = {};
+	Upload(m_frame, &frame, sizeof(frame));
+	Upload(m_lights, &lights, sizeof(lights));
+	Upload(m_material, &material, sizeof(material));
+
+	glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_BLOCK_BINDING, m_frame);
+	glBindBufferBase(GL_UNIFORM_BUFFER, LIGHTS_BLOCK_BINDING, m_lights);
+	glBindBufferBase(GL_UNIFORM_BUFFER, MATERIAL_BLOCK_BINDING, m_material);
+}
+void UniformBlocks::Shutdown()
+{
+	if (!m_frame)
+		return;
+	glDeleteBuffers(1, &m_frame);
+	glDeleteBuffers(1, &m_lights);
+	glDeleteBuffers(1, &m_material);
+	m_frame = m_lights = m_material = 0;
+}
+void UniformBlocks::UpdateFrame(Camera* camera, float aspect)
+{
+	FrameBlock frame;
+	frame.view = camera->GetViewMatrix();
+	frame.projection = glm::perspective(glm::radians(camera->zoom), aspect, 0.1f, 100.0f);
+	frame.cam_pos = glm::vec4(camera->position, 1.f);
+	Upload(m_frame, &frame, sizeof(frame));
+}
+void UniformBlocks::UpdateLights(const glm::vec3* positions, const glm::vec3* colors, int count)
+{
+	LightsBlock lights = {};
+	lights.count = std::min(count, MAX_BLOCK_LIGHTS);
+	for (int i = 0; i < lights.count; ++i)
+	{
+		lights.positions[i] = glm::vec4(positions[i], 1.f);
+		lights.colors[i] = glm::vec4(colors[i], 1.f);
+	}
+	Upload(m_lights, &lights, sizeof(lights));
+}
+void UniformBlocks::UpdateMaterial(float metallic, float roughness, bool metallic_status, bool roughness_status)
+{
+	MaterialBlock material;
+	material.metallic = metallic;
+	material.roughness = roughness;
+	material.metallic_status = metallic_status;
+	material.roughness_status = roughness_status;
+	Upload(m_material, &material, sizeof(material));
+}
+void UniformBlocks::Upload(unsigned buffer, const void* data, size_t size)
+{
+	// nothing to update before Init or after Shutdown
+	if (!buffer)
+		return;
+	// orphaned each time, the draws of the last frame may still read the old storage
+	glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+	glBufferData(GL_UNIFORM_BUFFER, size, data, GL_DYNAMIC_DRAW);
+}
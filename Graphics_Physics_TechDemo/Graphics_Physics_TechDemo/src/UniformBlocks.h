@@ -0,0 +1,75 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: UniformBlocks.h
+Purpose: std140 uniform buffers for the camera, lights and material shared by the scene shaders
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#pragma once
+
+#ifndef UNIFORMBLOCKS_H
+#define UNIFORMBLOCKS_H
+
+#include "glm/glm.hpp"
+
+// binding points, Shader binds the blocks of these names when a program links
+#define FRAME_BLOCK_BINDING 0
+#define LIGHTS_BLOCK_BINDING 1
+#define MATERIAL_BLOCK_BINDING 2
+#define FRAME_BLOCK_NAME "FrameBlock"
+#define LIGHTS_BLOCK_NAME "LightsBlock"
+#define MATERIAL_BLOCK_NAME "MaterialBlock"
+// size of the light arrays in pbr_texture.fs
+#define MAX_BLOCK_LIGHTS 20
+
+class Camera;
+
+// the layouts below mirror the std140 blocks in pbr_texture.vs/.fs, light.fs and background.vs
+struct FrameBlock {
+	glm::mat4 view;
+	glm::mat4 projection;
+	glm::vec4 cam_pos;
+};
+
+struct LightsBlock {
+	glm::vec4 positions[MAX_BLOCK_LIGHTS];
+	glm::vec4 colors[MAX_BLOCK_LIGHTS];
+	int count;
+	int pad[3];
+};
+
+struct MaterialBlock {
+	float metallic;
+	float roughness;
+	int metallic_status;
+	int roughness_status;
+};
+
+// owns one buffer per block, bound to its binding point for the lifetime of the context
+class UniformBlocks {
+public:
+	UniformBlocks();
+	~UniformBlocks();
+
+	void Init();
+	void Shutdown();
+
+	// view, projection and camPos once per frame instead of per draw
+	void UpdateFrame(Camera* camera, float aspect);
+	void UpdateLights(const glm::vec3* positions, const glm::vec3* colors, int count);
+	void UpdateMaterial(float metallic, float roughness, bool metallic_status, bool roughness_status);
+private:
+	UniformBlocks(const UniformBlocks&);
+	UniformBlocks& operator=(const UniformBlocks&);
+
+	void Upload(unsigned buffer, const void* data, size_t size);
+
+	unsigned m_frame, m_lights, m_material;
+};
+
+#endif
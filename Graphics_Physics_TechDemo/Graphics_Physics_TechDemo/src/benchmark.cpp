@@ -0,0 +1,291 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: benchmark.cpp
+Purpose: Microbenchmarks of the softbody kernels, table or JSON output
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#include "Base.h"
+#include "ParticleKernels.h"
+#include "SceneContent.h"
+#include "ThreadPool.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <vector>
+
+#define BENCH_DT (1.f / 60.f)
+
+namespace
+{
+	struct BenchResult {
+		std::string name;
+		unsigned long long iterations;
+		double ns;				// per iteration
+		unsigned particles;		// touched per iteration
+		unsigned constraints;	// solved per iteration, 0 when it doesn't apply
+	};
+
+	struct BenchOptions {
+		std::string filter;
+		double min_time;
+	};
+
+	// grow the batch until one takes min_time, the last batch gives the time per iteration
+	double Measure(const std::function<void()>& body, double min_time, unsigned long long& iterations)
+	{
+		body();
+		unsigned long long batch = 1;
+		for (;;)
+		{
+			std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+			for (unsigned long long i = 0; i < batch; ++i)
+				body();
+			double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+			if (seconds >= min_time || batch >= (1ull << 30))
+			{
+				iterations = batch;
+				return seconds * 1e9 / static_cast<double>(batch);
+			}
+			unsigned long long next = seconds > 0.0 ? static_cast<unsigned long long>(batch * min_time * 1.4 / seconds) : batch * 10;
+			batch = next > batch * 10 ? batch * 10 : (next < batch * 2 ? batch * 2 : next);
+		}
+	}
+
+	void Run(const BenchOptions& options, std::vector<BenchResult>& results, const std::string& name,
+		unsigned particles, unsigned constraints, const std::function<void()>& body)
+	{
+		BenchResult result;
+		result.name = name;
+		result.particles = particles;
+		result.constraints = constraints;
+		result.ns = Measure(body, options.min_time, result.iterations);
+		results.push_back(result);
+
+		printf("%-36s %12.0f ns %10llu  %8.3f ns/particle", name.c_str(), result.ns, result.iterations,
+			particles ? result.ns / particles : 0.0);
+		if (constraints)
+			printf("  %8.3f ns/constraint", result.ns / constraints);
+		printf("\n");
+	}
+
+	bool Selected(const BenchOptions& options, const std::string& name)
+	{
+		return options.filter.empty() || name.find(options.filter) != std::string::npos;
+	}
+
+	const char* ShapeName(ObjectShape shape)
+	{
+		return shape == O_PLANE ? "plane" : "sphere";
+	}
+
+	SoftBodyPhysics* MakeBody(ObjectShape shape, glm::vec3 pos, int dim)
+	{
+		if (shape == O_PLANE)
+			return new SoftBodyPhysics(O_PLANE, pos, glm::vec3(6.f, 1.f, 10.f), dim);
+		return new SoftBodyPhysics(O_SPHERE, pos, glm::vec3(1.f, 1.f, 1.f), dim);
+	}
+
+	void BenchVerlet(const BenchOptions& options, std::vector<BenchResult>& results, ObjectShape shape, int dim)
+	{
+		std::string name = std::string("Verlet/") + ShapeName(shape) + "/" + std::to_string(dim);
+		if (!Selected(options, name))
+			return;
+		SoftBodyPhysics* body = MakeBody(shape, glm::vec3(0.f), dim);
+		Run(options, results, name, body->m_scaled_ver.size(), 0, [body] { body->Verlet(BENCH_DT); });
+		delete body;
+	}
+
+	void BenchKeepConstraint(const BenchOptions& options, std::vector<BenchResult>& results, ObjectShape shape, int dim)
+	{
+		std::string name = std::string("KeepConstraint/") + ShapeName(shape) + "/" + std::to_string(dim);
+		if (!Selected(options, name))
+			return;
+		SoftBodyPhysics* body = MakeBody(shape, glm::vec3(0.f), dim);
+		Run(options, results, name, body->m_scaled_ver.size(), body->ConstraintCount() * KEEP_CONS_ITERATIONS,
+			[body] { body->KeepConstraint(BENCH_DT); });
+		delete body;
+	}
+
+	void BenchCollisionRigid(const BenchOptions& options, std::vector<BenchResult>& results, ObjectShape rigid_shape, int dim)
+	{
+		std::string name = std::string("CollisionRigid/") + ShapeName(rigid_shape) + "/" + std::to_string(dim);
+		if (!Selected(options, name))
+			return;
+		// the softbody sphere half sinks into the rigid body, every call starts from the same particles
+		SoftBodyPhysics* body = MakeBody(O_SPHERE, glm::vec3(0.f), dim);
+		Object* rigid = rigid_shape == O_PLANE
+			? new Object(O_PLANE, glm::vec3(-5.f, 0.1f, -5.f), glm::vec3(10.f, 1.f, 10.f), P_DIMENSION)
+			: new Object(O_SPHERE, glm::vec3(1.f, 0.f, 0.f), glm::vec3(1.f), MID_S_DIMENSION);
+		rigid->UpdateModel();
+		Run(options, results, name, body->m_scaled_ver.size(), 0, [body, rigid] {
+			body->BeginContacts();
+			body->CollisionResponseRigid(rigid);
+		});
+		delete rigid;
+		delete body;
+	}
+
+	void BenchCollisionSoft(const BenchOptions& options, std::vector<BenchResult>& results, int dim, unsigned count)
+	{
+		std::string name = "CollisionSoft/" + std::to_string(dim) + "/" + std::to_string(count);
+		if (!Selected(options, name))
+			return;
+		// a row of spheres, each one overlapping its neighbours
+		std::vector<SoftBodyPhysics*> bodies;
+		unsigned particles = 0;
+		for (unsigned i = 0; i < count; ++i)
+		{
+			bodies.push_back(MakeBody(O_SPHERE, glm::vec3(1.6f * i, 0.f, 0.f), dim));
+			bodies.back()->Update(BENCH_DT);
+			particles += bodies.back()->m_scaled_ver.size();
+		}
+		Run(options, results, name, particles, 0, [&bodies] {
+			for (auto body : bodies)
+				body->BeginContacts();
+			for (unsigned i = 0; i < bodies.size(); ++i)
+				for (unsigned j = 0; j < bodies.size(); ++j)
+					if (i != j)
+						bodies[i]->CollisionResponseSoft(bodies[j]);
+		});
+		for (auto body : bodies)
+			delete body;
+	}
+
+	const char* SimdName(SimdLevel level)
+	{
+		return level == SIMD_AVX2 ? "avx2" : (level == SIMD_SSE2 ? "sse2" : "scalar");
+	}
+
+	bool WriteJson(const char* path, const std::vector<BenchResult>& results)
+	{
+		FILE* file = fopen(path, "w");
+		if (!file)
+			return false;
+
+		char date[64];
+		std::time_t now = std::time(nullptr);
+		std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+		fprintf(file, "{\n  \"context\": {\n");
+		fprintf(file, "    \"date\": \"%s\",\n", date);
+		fprintf(file, "    \"threads\": %u,\n", ThreadPool::Instance().size());
+		fprintf(file, "    \"simd\": \"%s\"\n", SimdName(GetSimdLevel()));
+		fprintf(file, "  },\n  \"benchmarks\": [\n");
+		for (unsigned i = 0; i < results.size(); ++i)
+		{
+			const BenchResult& r = results[i];
+			fprintf(file, "    {\n");
+			fprintf(file, "      \"name\": \"%s\",\n", r.name.c_str());
+			fprintf(file, "      \"iterations\": %llu,\n", r.iterations);
+			fprintf(file, "      \"real_time\": %.3f,\n", r.ns);
+			fprintf(file, "      \"time_unit\": \"ns\",\n");
+			fprintf(file, "      \"particles\": %u,\n", r.particles);
+			fprintf(file, "      \"constraints\": %u,\n", r.constraints);
+			fprintf(file, "      \"ns_per_particle\": %.4f", r.particles ? r.ns / r.particles : 0.0);
+			if (r.constraints)
+				fprintf(file, ",\n      \"ns_per_constraint\": %.4f", r.ns / r.constraints);
+			fprintf(file, "\n    }%s\n", i + 1 < results.size() ? "," : "");
+		}
+		fprintf(file, "  ]\n}\n");
+		fclose(file);
+		return true;
+	}
+
+	void PrintUsage()
+	{
+		printf("usage: Physics_Benchmark [--filter substring] [--min-time seconds] [--json file] [--simd 0-2]\n");
+	}
+
+	// whole argument must be a number in [min, max]
+	bool ParseInt(const char* arg, long min, long max, long& value)
+	{
+		char* end;
+		errno = 0;
+		value = strtol(arg, &end, 10);
+		return end != arg && !*end && errno != ERANGE && value >= min && value <= max;
+	}
+	bool ParseFloat(const char* arg, double min, double max, double& value)
+	{
+		char* end;
+		errno = 0;
+		value = strtod(arg, &end);
+		return end != arg && !*end && errno != ERANGE && value >= min && value <= max;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchOptions options;
+	options.min_time = 0.2;
+	const char* json = nullptr;
+	for (int i = 1; i < argc; ++i)
+	{
+		long number;
+		bool valid = i + 1 < argc;
+		if (valid && !strcmp(argv[i], "--filter"))
+			options.filter = argv[++i];
+		else if (valid && !strcmp(argv[i], "--min-time"))
+			valid = ParseFloat(argv[++i], 0.0, 3600.0, options.min_time);
+		else if (valid && !strcmp(argv[i], "--json"))
+			json = argv[++i];
+		else if (valid && !strcmp(argv[i], "--simd"))
+		{
+			valid = ParseInt(argv[++i], SIMD_SCALAR, SIMD_AVX2, number);
+			if (valid)
+				SetSimdLevel(static_cast<SimdLevel>(number));
+		}
+		else
+			valid = false;
+		if (!valid)
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	// no GL context here, objects only build their geometry
+	Object::headless = true;
+	printf("%u threads, %s kernels\n", ThreadPool::Instance().size(), SimdName(GetSimdLevel()));
+
+	const int dims[] = { S_DIMENSION, MID_S_DIMENSION, HIGH_S_DIMENSION, P_DIMENSION, 2 * P_DIMENSION };
+	const unsigned counts[] = { 2, 4, 8, 16 };
+	std::vector<BenchResult> results;
+
+	for (int dim : dims)
+	{
+		BenchVerlet(options, results, O_SPHERE, dim);
+		BenchVerlet(options, results, O_PLANE, dim);
+	}
+	for (int dim : dims)
+	{
+		BenchKeepConstraint(options, results, O_SPHERE, dim);
+		BenchKeepConstraint(options, results, O_PLANE, dim);
+	}
+	for (int dim : dims)
+	{
+		BenchCollisionRigid(options, results, O_SPHERE, dim);
+		BenchCollisionRigid(options, results, O_PLANE, dim);
+	}
+	for (int dim : dims)
+		for (unsigned count : counts)
+			BenchCollisionSoft(options, results, dim, count);
+
+	if (json && !WriteJson(json, results))
+	{
+		printf("could not write %s\n", json);
+		return 1;
+	}
+	return 0;
+}
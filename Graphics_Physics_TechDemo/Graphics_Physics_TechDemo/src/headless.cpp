@@ -0,0 +1,144 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: headless.cpp
+Purpose: Runs the scene physics without a window and reports throughput and a checksum
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#include "Base.h"
+#include "Physics.h"
+#include "SceneContent.h"
+#include "ThreadPool.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+
+namespace
+{
+	void PrintUsage()
+	{
+		printf("usage: Physics_Headless [--scene 0-5|all] [--steps N] [--dt seconds]\n");
+	}
+
+	// whole argument must be a number in [min, max]
+	bool ParseInt(const char* arg, long min, long max, long& value)
+	{
+		char* end;
+		errno = 0;
+		value = strtol(arg, &end, 10);
+		return end != arg && !*end && errno != ERANGE && value >= min && value <= max;
+	}
+	bool ParseFloat(const char* arg, double min, double max, double& value)
+	{
+		char* end;
+		errno = 0;
+		value = strtod(arg, &end);
+		return end != arg && !*end && errno != ERANGE && value >= min && value <= max;
+	}
+
+	void RunScene(unsigned scene, unsigned steps, float dt)
+	{
+		SceneContent content;
+		BuildSceneContent(scene, content);
+		if (content.softbody.empty())
+		{
+			printf("scene %u: no physics content\n", scene);
+			return;
+		}
+
+		Physics physics;
+		unsigned particles = 0;
+		for (auto rigid : content.rigid)
+			physics.push_object(rigid);
+		for (auto soft : content.softbody)
+		{
+			physics.push_object(soft);
+			particles += soft->m_scaled_ver.size();
+		}
+
+		PhysicsTimings total = { 0.0, 0.0, 0.0 };
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		for (unsigned i = 0; i < steps; ++i)
+		{
+			physics.update(dt);
+			total.integrate += physics.timings().integrate;
+			total.broadphase += physics.timings().broadphase;
+			total.contacts += physics.timings().contacts;
+		}
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+		double sum = 0.0;
+		uint64_t hash = ParticleChecksum(content.softbody, sum);
+		printf("scene %u: %u softbodies, %u particles, %u rigid, %u steps in %.3f ms, %.1f steps/sec\n",
+			scene, static_cast<unsigned>(content.softbody.size()), particles, static_cast<unsigned>(content.rigid.size()),
+			steps, ms, ms > 0.0 ? steps * 1000.0 / ms : 0.0);
+		if (steps)
+			printf("  per step: integrate %.4f ms, broadphase %.4f ms, contacts %.4f ms\n",
+				total.integrate / steps, total.broadphase / steps, total.contacts / steps);
+		printf("  checksum %016llx (sum %.9g)\n", static_cast<unsigned long long>(hash), sum);
+
+		physics.clear_objects();
+		for (auto rigid : content.rigid)
+			delete rigid;
+		for (auto soft : content.softbody)
+			delete soft;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int scene = -1;
+	unsigned steps = 1000;
+	float dt = PHYSICS_STEP;
+	for (int i = 1; i < argc; ++i)
+	{
+		long number;
+		double real;
+		bool valid = i + 1 < argc;
+		if (valid && !strcmp(argv[i], "--scene"))
+		{
+			++i;
+			valid = !strcmp(argv[i], "all") || ParseInt(argv[i], 0, SCENE_COUNT - 1, number);
+			scene = strcmp(argv[i], "all") ? static_cast<int>(number) : -1;
+		}
+		else if (valid && !strcmp(argv[i], "--steps"))
+		{
+			valid = ParseInt(argv[++i], 1, 100000000, number);
+			steps = static_cast<unsigned>(number);
+		}
+		else if (valid && !strcmp(argv[i], "--dt"))
+		{
+			valid = ParseFloat(argv[++i], 1e-6, 1.0, real);
+			dt = static_cast<float>(real);
+		}
+		else
+			valid = false;
+		if (!valid)
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	// no GL context here, objects only build their geometry
+	Object::headless = true;
+	printf("%u threads, dt %g\n", ThreadPool::Instance().size(), dt);
+
+	if (scene < 0)
+	{
+		for (unsigned s = 0; s < SCENE_COUNT; ++s)
+			RunScene(s, steps, dt);
+	}
+	else
+		RunScene(static_cast<unsigned>(scene), steps, dt);
+	return 0;
+}
@@ -87,6 +87,7 @@ int main(void)
 	}
 	m_scene.DeleteBuffers();
 	m_scene.ShutDown();
+	GpuSoftBody::ShutDown();
 	m_scene.ImGuiShutdown();
 	DeleteBuffers();
 
@@ -0,0 +1,848 @@
+/* Start Header -------------------------------------------------------
+Copyright (C) 2026 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+File Name: tests.cpp
+Purpose: Self checking tests of the loaders, caches and solvers, exits non zero on a failure
+Language: MSVC C++
+Platform: VS2019, Windows
+Project: Graphics_Physics_TechDemo
+Author: agent, agent@local
+Creation date: 10/17/2026
+End Header --------------------------------------------------------*/
+#include "glad/glad.h"
+#include "GLFW/glfw3.h"
+#include "Base.h"
+#include "Broadphase.h"
+#include "MeshCache.h"
+#include "ObjLoader.h"
+#include "ParticleKernels.h"
+#include "Physics.h"
+#include "SceneContent.h"
+#include "TextureCache.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#if defined(_WIN32)
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+
+#define CHECK(condition) Check((condition), #condition, __FILE__, __LINE__)
+// how far the ramp image's red moves across one 4 texel block
+#define RAMP_SPAN (255 * 3 / 17)
+// steps the CPU and the compute path run scene BACKEND_SCENE before their particles are compared. Scene 1
+// drapes the cloth over the three spheres well before then; scene 0 isn't used, its sphere tumbling down
+// the ramps turns a 1e-6 nudge into a 0.1 difference on the CPU alone
+#define BACKEND_SCENE 1
+#define BACKEND_STEPS 240
+// the compute path sums in another order, llvmpipe ends up 1.5e-4 away, skipping its contacts 1.5
+#define BACKEND_EPSILON 1e-3f
+// random box sets the broadphase is checked on
+#define BROADPHASE_ROUNDS 20
+// deform / refit / collide rounds of the triangle tree test
+#define TREE_ROUNDS 4
+// random frame times the accumulator test feeds to Physics::step
+#define STEP_FRAMES 1000
+// workers of the pool the thread count test compares against a single thread
+#define TEST_THREADS 4
+// steps every physics scene runs before the checksums of two configurations are compared
+#define CHECKSUM_STEPS 120
+
+namespace
+{
+	unsigned failures = 0;
+
+	void Check(bool passed, const char* condition, const char* file, int line)
+	{
+		if (passed)
+			return;
+		printf("  failed: %s (%s:%d)\n", condition, file, line);
+		++failures;
+	}
+
+	// reference decoders written from the format specs, not shared with the encoders they check
+	void DecodeBC4(const unsigned char* block, unsigned char values[16])
+	{
+		int e0 = block[0], e1 = block[1];
+		int palette[8] = { e0, e1 };
+		for (int i = 2; i < 8; ++i)
+		{
+			if (e0 > e1)
+				palette[i] = ((8 - i) * e0 + (i - 1) * e1 + 3) / 7;
+			else
+				palette[i] = i < 6 ? ((6 - i) * e0 + (i - 1) * e1 + 2) / 5 : (i == 6 ? 0 : 255);
+		}
+		unsigned long long indices = 0;
+		for (int i = 0; i < 6; ++i)
+			indices |= static_cast<unsigned long long>(block[2 + i]) << (8 * i);
+		for (int i = 0; i < 16; ++i)
+			values[i] = static_cast<unsigned char>(palette[(indices >> (3 * i)) & 7]);
+	}
+	void DecodeBC1(const unsigned char* block, unsigned char texels[16][3])
+	{
+		unsigned colors[2] = { static_cast<unsigned>(block[0] | block[1] << 8), static_cast<unsigned>(block[2] | block[3] << 8) };
+		int palette[4][3];
+		for (int e = 0; e < 2; ++e)
+		{
+			palette[e][0] = ((colors[e] >> 11) * 255 + 15) / 31;
+			palette[e][1] = (((colors[e] >> 5) & 63) * 255 + 31) / 63;
+			palette[e][2] = ((colors[e] & 31) * 255 + 15) / 31;
+		}
+		for (int c = 0; c < 3; ++c)
+		{
+			if (colors[0] > colors[1])
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+			}
+			else
+			{
+				palette[2][c] = (palette[0][c] + palette[1][c] + 1) / 2;
+				palette[3][c] = 0;
+			}
+		}
+		unsigned indices = block[4] | block[5] << 8u | block[6] << 16u | static_cast<unsigned>(block[7]) << 24u;
+		for (int i = 0; i < 16; ++i)
+			for (int c = 0; c < 3; ++c)
+				texels[i][c] = static_cast<unsigned char>(palette[(indices >> (2 * i)) & 3][c]);
+	}
+	// only mode 6 (one subset, 7777.1 endpoints, 4 bit indices), false for any other mode
+	bool DecodeBC7(const unsigned char* block, unsigned char texels[16][4])
+	{
+		unsigned position = 0;
+		auto get = [&](unsigned count) {
+			unsigned value = 0;
+			for (unsigned bit = 0; bit < count; ++bit, ++position)
+				value |= ((block[position / 8] >> (position % 8)) & 1u) << bit;
+			return value;
+		};
+		if (get(7) != 1 << 6)
+			return false;
+		int endpoints[2][4];
+		for (int c = 0; c < 4; ++c)
+		{
+			endpoints[0][c] = static_cast<int>(get(7)) << 1;
+			endpoints[1][c] = static_cast<int>(get(7)) << 1;
+		}
+		for (int e = 0; e < 2; ++e)
+		{
+			int p = static_cast<int>(get(1));
+			for (int c = 0; c < 4; ++c)
+				endpoints[e][c] |= p;
+		}
+		static const int weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+		for (int i = 0; i < 16; ++i)
+		{
+			int index = static_cast<int>(get(i ? 4 : 3));
+			for (int c = 0; c < 4; ++c)
+				texels[i][c] = static_cast<unsigned char>(((64 - weights[index]) * endpoints[0][c] + weights[index] * endpoints[1][c] + 32) >> 6);
+		}
+		return true;
+	}
+
+	// encodes a width x height rgb image with TextureCache::Encode, decodes it block by block and
+	// returns the largest difference of any channel the format stores. -1 when a block doesn't decode
+	int RoundTripError(unsigned format, const std::vector<unsigned char>& rgb, unsigned width, unsigned height)
+	{
+		std::vector<unsigned char> encoded(TextureCache::LevelSize(format, width, height));
+		TextureCache::Encode(format, &rgb[0], width, height, &encoded[0]);
+		const size_t block_bytes = encoded.size() / (((width + 3) / 4) * ((height + 3) / 4));
+		const unsigned char* block = &encoded[0];
+		int error = 0;
+		for (unsigned by = 0; by < height; by += 4)
+			for (unsigned bx = 0; bx < width; bx += 4, block += block_bytes)
+			{
+				unsigned char decoded[16][3] = {};
+				if (format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT)
+					DecodeBC1(block, decoded);
+				else if (format == GL_COMPRESSED_RGBA_BPTC_UNORM)
+				{
+					unsigned char rgba[16][4];
+					if (!DecodeBC7(block, rgba))
+						return -1;
+					for (int i = 0; i < 16; ++i)
+						memcpy(decoded[i], rgba[i], 3);
+				}
+				else
+				{
+					unsigned char values[16];
+					DecodeBC4(block, values);
+					for (int i = 0; i < 16; ++i)
+						decoded[i][0] = values[i];
+					if (format == GL_COMPRESSED_RG_RGTC2)
+					{
+						DecodeBC4(block + 8, values);
+						for (int i = 0; i < 16; ++i)
+							decoded[i][1] = values[i];
+					}
+				}
+				const int channels = format == GL_COMPRESSED_RED_RGTC1 ? 1 : (format == GL_COMPRESSED_RG_RGTC2 ? 2 : 3);
+				for (unsigned y = 0; y < 4 && by + y < height; ++y)
+					for (unsigned x = 0; x < 4 && bx + x < width; ++x)
+						for (int c = 0; c < channels; ++c)
+						{
+							int source = rgb[((by + y) * width + bx + x) * 3 + c];
+							error = std::max(error, abs(source - decoded[y * 4 + x][c]));
+						}
+			}
+		return error;
+	}
+
+	// synthetic images: one flat color, two colors in a checker, and a ramp between two colors
+	// along x that covers several blocks and leaves partial blocks on the right and bottom edge
+	std::vector<unsigned char> Flat(unsigned width, unsigned height)
+	{
+		std::vector<unsigned char> rgb(width * height * 3);
+		for (size_t i = 0; i < rgb.size(); i += 3)
+		{
+			rgb[i] = 200;
+			rgb[i + 1] = 100;
+			rgb[i + 2] = 50;
+		}
+		return rgb;
+	}
+	std::vector<unsigned char> Checker(unsigned width, unsigned height)
+	{
+		std::vector<unsigned char> rgb(width * height * 3);
+		for (unsigned y = 0; y < height; ++y)
+			for (unsigned x = 0; x < width; ++x)
+			{
+				bool dark = (x + y) & 1;
+				unsigned char* texel = &rgb[(y * width + x) * 3];
+				texel[0] = dark ? 16 : 240;
+				texel[1] = dark ? 32 : 224;
+				texel[2] = dark ? 64 : 192;
+			}
+		return rgb;
+	}
+	std::vector<unsigned char> Ramp(unsigned width, unsigned height)
+	{
+		std::vector<unsigned char> rgb(width * height * 3);
+		for (unsigned y = 0; y < height; ++y)
+			for (unsigned x = 0; x < width; ++x)
+			{
+				unsigned char* texel = &rgb[(y * width + x) * 3];
+				texel[0] = static_cast<unsigned char>(255 * x / (width - 1));
+				texel[1] = static_cast<unsigned char>(64 + 128 * x / (width - 1));
+				texel[2] = static_cast<unsigned char>(192 - 192 * x / (width - 1));
+			}
+		return rgb;
+	}
+
+	// tolerances: BC4 stores 8 bit endpoints exactly and spaces 8 values between them, BC1 loses up to
+	// 4 to 565 and spaces 4 colors, BC7 mode 6 loses 1 to the shared p bit and spaces 16. Across one
+	// block of the ramp the widest channel changes by RAMP_SPAN, a texel is at most half a step off
+	void TestBC4()
+	{
+		CHECK(RoundTripError(GL_COMPRESSED_RED_RGTC1, Flat(8, 8), 8, 8) == 0);
+		CHECK(RoundTripError(GL_COMPRESSED_RED_RGTC1, Checker(8, 8), 8, 8) == 0);
+		CHECK(RoundTripError(GL_COMPRESSED_RED_RGTC1, Ramp(18, 7), 18, 7) <= RAMP_SPAN / 14 + 1);
+	}
+	void TestBC5()
+	{
+		CHECK(RoundTripError(GL_COMPRESSED_RG_RGTC2, Flat(8, 8), 8, 8) == 0);
+		CHECK(RoundTripError(GL_COMPRESSED_RG_RGTC2, Checker(8, 8), 8, 8) == 0);
+		CHECK(RoundTripError(GL_COMPRESSED_RG_RGTC2, Ramp(18, 7), 18, 7) <= RAMP_SPAN / 14 + 1);
+	}
+	void TestBC1()
+	{
+		CHECK(RoundTripError(GL_COMPRESSED_RGB_S3TC_DXT1_EXT, Flat(8, 8), 8, 8) <= 4);
+		CHECK(RoundTripError(GL_COMPRESSED_RGB_S3TC_DXT1_EXT, Checker(8, 8), 8, 8) <= 4);
+		CHECK(RoundTripError(GL_COMPRESSED_RGB_S3TC_DXT1_EXT, Ramp(18, 7), 18, 7) <= RAMP_SPAN / 6 + 4);
+	}
+	void TestBC7()
+	{
+		int flat = RoundTripError(GL_COMPRESSED_RGBA_BPTC_UNORM, Flat(8, 8), 8, 8);
+		int checker = RoundTripError(GL_COMPRESSED_RGBA_BPTC_UNORM, Checker(8, 8), 8, 8);
+		int ramp = RoundTripError(GL_COMPRESSED_RGBA_BPTC_UNORM, Ramp(18, 7), 18, 7);
+		CHECK(flat >= 0 && flat <= 1);
+		CHECK(checker >= 0 && checker <= 1);
+		CHECK(ramp >= 0 && ramp <= RAMP_SPAN / 30 + 1);
+	}
+
+	// writes text to a scratch file in the working directory and loads it
+	bool LoadObjText(const char* text, ObjMesh& mesh)
+	{
+		const char* path = "tests_scratch.obj";
+		FILE* file = fopen(path, "wb");
+		if (!file)
+			return false;
+		fputs(text, file);
+		fclose(file);
+		mesh = ObjMesh();
+		bool loaded = LoadObj(path, mesh);
+		remove(path);
+		return loaded;
+	}
+
+	void TestObjFaces()
+	{
+		ObjMesh mesh;
+		// a quad splits 0-1-3 / 1-2-3, a pentagon fans around its first corner
+		CHECK(LoadObjText("v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nv 0 2 0\nf 1 2 3 4\nf 1 2 3 4 5\n", mesh));
+		const unsigned expected[] = { 0, 1, 3, 1, 2, 3, 0, 1, 2, 0, 2, 3, 0, 3, 4 };
+		CHECK(mesh.positions.size() == 5);
+		CHECK(mesh.position_indices == std::vector<unsigned>(expected, expected + 15));
+		// comments and other keywords are skipped, a trailing comment ends the face
+		CHECK(LoadObjText("# c\nmtllib a.mtl\nv 0 0 0\nv 1 0 0\nv 1 1 0\nusemtl m\ns off\nf 1 2 3 # c\n", mesh));
+		CHECK(mesh.position_indices.size() == 3);
+	}
+	void TestObjNegativeIndices()
+	{
+		ObjMesh mesh;
+		// relative to the elements read before the face, not the whole file
+		CHECK(LoadObjText("v 0 0 0\nv 1 0 0\nv 1 1 0\nvt 0 0\nvt 1 1\nf -3/-2 -2/-1 -1/-1\nv 5 5 5\nf -1 -2 -3\n", mesh));
+		const unsigned positions[] = { 0, 1, 2, 3, 2, 1 };
+		const unsigned uvs[] = { 0, 1, 1, OBJ_NO_UV, OBJ_NO_UV, OBJ_NO_UV };
+		CHECK(mesh.position_indices == std::vector<unsigned>(positions, positions + 6));
+		CHECK(mesh.uv_indices == std::vector<unsigned>(uvs, uvs + 6));
+		CHECK(!LoadObjText("v 0 0 0\nv 1 0 0\nf -1 -2 -3\nv 1 1 0\n", mesh));
+	}
+	void TestObjMissingUv()
+	{
+		ObjMesh mesh;
+		// a corner without vt must not alias the first vt
+		CHECK(LoadObjText("v 0 0 0\nv 1 0 0\nv 1 1 0\nvt 0.5 0.5\nf 1//1 2/1 3/1/1\n", mesh));
+		const unsigned uvs[] = { OBJ_NO_UV, 0, 0 };
+		CHECK(mesh.uv_indices == std::vector<unsigned>(uvs, uvs + 3));
+		CHECK(LoadObjText("v 0 0 0\nv 1 0 0\nv 1 1 0\nf 1 2 3\n", mesh));
+		CHECK(mesh.uvs.empty() && mesh.uv_indices == std::vector<unsigned>(3, OBJ_NO_UV));
+	}
+	void TestObjMalformed()
+	{
+		ObjMesh mesh;
+		const char* vertices = "v 0 0 0\nv 1 0 0\nv 1 1 0\nvt 0 0\n";
+		const char* faces[] = {
+			"f 1 2\n",			// fewer than three corners
+			"f 0 1 2\n",		// indices are 1 based
+			"f 1/0 2/1 3/1\n",	// so are vt indices
+			"f 1 2 4\n",		// past the last v
+			"f 1/2 2/1 3/1\n",	// past the last vt
+			"f 1 x 3\n",
+			"f 1 2/ 3\n",
+			"f 1 2 3x\n",
+		};
+		for (const char* face : faces)
+		{
+			std::string text = std::string(vertices) + face;
+			bool loaded = LoadObjText(text.c_str(), mesh);
+			Check(!loaded, face, __FILE__, __LINE__);
+		}
+		CHECK(!LoadObjText("v 0 0\n", mesh));
+		CHECK(!LoadObjText("v 0 x 0\n", mesh));
+		CHECK(!LoadObjText("vt .\n", mesh));
+		CHECK(!LoadObj("tests_missing.obj", mesh));
+	}
+	void TestObjFloats()
+	{
+		// every value must round to the same float strtof gives
+		const char* numbers[] = {
+			"0", "-0.5", "1", "0.1", "3.14159274", "-123.456", "1e-3", "2.5E+2", "0.000001",
+			"16777217", "0.1234567890123456789012", "3.4028235e38", "1.17549435e-38", "123456789e-15", "7.",
+			// just above halfway between two floats, but rounds to exactly halfway as a double
+			"1.00000005960464477550",
+		};
+		ObjMesh mesh;
+		for (const char* number : numbers)
+		{
+			std::string text = std::string("v ") + number + " 0 " + number + "\n";
+			bool equal = LoadObjText(text.c_str(), mesh) && mesh.positions.size() == 1
+				&& mesh.positions[0].x == strtof(number, nullptr) && mesh.positions[0].z == strtof(number, nullptr);
+			Check(equal, number, __FILE__, __LINE__);
+		}
+	}
+
+	// loads path into a fresh O_OBJ object, then moves one vertex and recomputes the normals, which
+	// needs the face adjacency
+	Object* LoadMeshObject(const char* path)
+	{
+		Object* object = new Object(O_OBJ, glm::vec3(0.f), glm::vec3(1.f), 0);
+		glm::vec3 middle;
+		if (!object->loadOBJ(path, middle))
+			return object;
+		object->LoadCachedGeometry();
+		object->obj_vertices[0] += glm::vec3(0.f, 0.f, 0.5f);
+		object->ComputeNormals();
+		return object;
+	}
+
+	// the second load maps the .mesh the first one wrote, the object has to end up the same
+	void TestMeshCacheHit()
+	{
+		const char* path = "tests_scratch_cache.obj";
+		const char* text = "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nv 0 0 1\nvt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+			"f 1/1 2/2 3/3 4/4\nf 1/1 2/2 5/3\nf 1/4 4/3 5/2\nf 2/1 3/2 5/4\n";
+		FILE* file = fopen(path, "wb");
+		CHECK(file != nullptr);
+		if (!file)
+			return;
+		fputs(text, file);
+		fclose(file);
+		remove(MeshCache::CachePath(path).c_str());
+
+		Object* miss = LoadMeshObject(path);
+		MeshCache cache;
+		CHECK(cache.Open(path));
+		cache.Close();
+		Object* hit = LoadMeshObject(path);
+
+		CHECK(!miss->obj_vertices.empty());
+		CHECK(hit->obj_vertices == miss->obj_vertices);
+		CHECK(hit->obj_indices == miss->obj_indices);
+		CHECK(hit->vertexNormals == miss->vertexNormals);
+		// the miss keeps a uv per triangle and reads 0 past that, the cache one per vertex
+		bool uvs = hit->textureUV_fromIndices.size() == hit->obj_vertices.size();
+		for (unsigned i = 0; uvs && i < hit->textureUV_fromIndices.size(); ++i)
+			uvs = hit->textureUV_fromIndices[i] == (i < miss->textureUV_fromIndices.size() ? miss->textureUV_fromIndices[i] : glm::vec2(0.f));
+		CHECK(uvs);
+		CHECK(hit->textureUV.size() == hit->obj_vertices.size() && hit->test_indices == hit->obj_indices);
+
+		// a hit copies nothing out of the mapping until asked to
+		Object lazy(O_OBJ, glm::vec3(0.f), glm::vec3(1.f), 0);
+		glm::vec3 middle;
+		CHECK(lazy.loadOBJ(path, middle) && lazy.obj_vertices.empty());
+
+		// touching the OBJ keeps the cache, and the first open after that takes the new mtime
+		utimbuf times;
+		times.actime = times.modtime = 1000000000;
+		CHECK(utime(path, &times) == 0);
+		unsigned long long size;
+		long long mtime;
+		CHECK(SourceStamp(path, size, mtime) && mtime == 1000000000);
+		CHECK(cache.Open(path) && cache.header().source_mtime == mtime);
+		cache.Close();
+
+		delete miss;
+		delete hit;
+		remove(path);
+		remove(MeshCache::CachePath(path).c_str());
+	}
+
+	// makeSphere repeats the x = 0 column at x = X_SEGMENTS and a whole row at each pole, all of them
+	// a rounding error apart. Every copy has to get the same normal or the seam shows up hard shaded
+	void TestSphereSeamNormals()
+	{
+		for (int dim : { S_DIMENSION, HIGH_S_DIMENSION })
+		{
+			SoftBodyPhysics sphere(O_SPHERE, glm::vec3(0.f), glm::vec3(1.f), dim);
+			const std::vector<glm::vec3>& positions = sphere.obj_vertices;
+			const std::vector<glm::vec3>& normals = sphere.vertexNormals;
+			unsigned copies = 0;
+			float worst = 0.f;
+			for (unsigned a = 0; a < positions.size(); ++a)
+				for (unsigned b = a + 1; b < positions.size(); ++b)
+					if (glm::length(positions[a] - positions[b]) < 1e-5f)
+					{
+						++copies;
+						worst = std::max(worst, glm::length(normals[a] - normals[b]));
+					}
+			// at least the dim + 1 seam pairs, the pole rows add more
+			CHECK(copies >= static_cast<unsigned>(dim + 1));
+			CHECK(worst == 0.f);
+		}
+	}
+
+	// headless checksum of every scene with physics content after CHECKSUM_STEPS fixed steps
+	std::vector<uint64_t> SceneChecksums()
+	{
+		std::vector<uint64_t> checksums;
+		for (unsigned scene = 0; scene < SCENE_COUNT; ++scene)
+		{
+			SceneContent content;
+			BuildSceneContent(scene, content);
+			if (content.softbody.empty())
+				continue;
+			Physics physics;
+			for (auto rigid : content.rigid)
+				physics.push_object(rigid);
+			for (auto soft : content.softbody)
+				physics.push_object(soft);
+			for (unsigned i = 0; i < CHECKSUM_STEPS; ++i)
+				physics.update(PHYSICS_STEP);
+			double sum;
+			checksums.push_back(ParticleChecksum(content.softbody, sum));
+			physics.clear_objects();
+			for (auto rigid : content.rigid)
+				delete rigid;
+			for (auto soft : content.softbody)
+				delete soft;
+		}
+		return checksums;
+	}
+
+	// the SSE2 and AVX2 kernels round like the scalar one, every level has to end on the same bits.
+	// Levels the cpu doesn't report are skipped
+	void TestSimdLevelsMatch()
+	{
+		SimdLevel supported = GetSimdLevel();
+		SetSimdLevel(SIMD_SCALAR);
+		std::vector<uint64_t> scalar = SceneChecksums();
+		CHECK(!scalar.empty());
+		const SimdLevel levels[] = { SIMD_SSE2, SIMD_AVX2 };
+		const char* names[] = { "SSE2", "AVX2" };
+		for (unsigned i = 0; i < 2; ++i)
+		{
+			SetSimdLevel(levels[i]);
+			if (GetSimdLevel() != levels[i])
+			{
+				printf("  skipped: no %s on this cpu\n", names[i]);
+				continue;
+			}
+			bool equal = SceneChecksums() == scalar;
+			Check(equal, names[i], __FILE__, __LINE__);
+		}
+		SetSimdLevel(supported);
+	}
+
+	// pushes a's particles out of b after wobbling b's particles and stepping it, which marks b's tree
+	// for a refit. With tree false b is collided by the linear scan over its triangles. colliding()
+	// after every round goes in flags. False when no particle of a was pushed
+	bool CollideDeformed(bool tree, ParticleArray& result, std::vector<bool>& flags)
+	{
+		SoftBodyPhysics a(O_SPHERE, glm::vec3(0.f), glm::vec3(1.f), S_DIMENSION);
+		SoftBodyPhysics b(O_SPHERE, glm::vec3(1.2f, 0.3f, 0.2f), glm::vec3(1.f), S_DIMENSION);
+		b.tree_min_triangles = tree ? 0 : ~0u;
+		for (unsigned round = 0; round < TREE_ROUNDS; ++round)
+		{
+			for (unsigned i = 0; i < b.m_scaled_ver.size(); ++i)
+				b.m_scaled_ver.add(i, 0.05f * glm::vec3(sinf(1.7f * i + round), cosf(0.9f * i), sinf(2.3f * i - round)));
+			b.Update(PHYSICS_STEP);
+			a.BeginContacts();
+			b.BeginContacts();
+			a.CollisionResponseSoft(&b);
+			flags.push_back(a.colliding());
+			a.EndContacts();
+			b.EndContacts();
+		}
+		// only the contacts move a, it isn't stepped
+		SoftBodyPhysics untouched(O_SPHERE, glm::vec3(0.f), glm::vec3(1.f), S_DIMENSION);
+		result = a.m_scaled_ver;
+		for (unsigned i = 0; i < result.size(); ++i)
+			if (result.get(i) != untouched.m_scaled_ver.get(i))
+				return true;
+		return false;
+	}
+
+	// the tree, built once and refit after every deformation, has to push the same particles to the
+	// same places as the linear scan it replaces and report a collision in the same rounds
+	void TestTreeMatchesLinearScan()
+	{
+		ParticleArray tree, linear;
+		std::vector<bool> tree_flags, linear_flags;
+		CHECK(CollideDeformed(true, tree, tree_flags));
+		CHECK(CollideDeformed(false, linear, linear_flags));
+		CHECK(tree_flags == linear_flags);
+		bool equal = tree.size() == linear.size();
+		for (unsigned i = 0; equal && i < tree.size(); ++i)
+			equal = tree.get(i) == linear.get(i);
+		CHECK(equal);
+	}
+
+	// part of a step is carried over, a hitch runs the capped step count and keeps only the
+	// fraction of a step past the cap, alpha stays in [0, 1) for any frame time
+	void TestStepAccumulator()
+	{
+		Physics physics;
+		const unsigned max_steps = static_cast<unsigned>(MAX_FRAME_TIME / PHYSICS_STEP + 0.5f);
+		CHECK(physics.step(0.5f * PHYSICS_STEP) == 0);
+		CHECK(fabsf(physics.get_alpha() - 0.5f) < 1e-4f);
+		CHECK(physics.step(0.75f * PHYSICS_STEP) == 1);
+		CHECK(fabsf(physics.get_alpha() - 0.25f) < 1e-4f);
+
+		// 0.25 + 60.25 steps with the cap at max_steps
+		CHECK(physics.step(1.f + 0.25f * PHYSICS_STEP) == max_steps);
+		CHECK(fabsf(physics.get_accumulator() - 0.5f * PHYSICS_STEP) < 1e-5f);
+		CHECK(fabsf(physics.get_alpha() - 0.5f) < 1e-3f);
+		CHECK(physics.step(0.75f * PHYSICS_STEP) == 1);
+		CHECK(fabsf(physics.get_alpha() - 0.25f) < 1e-3f);
+
+		std::mt19937 random(3);
+		std::uniform_real_distribution<float> frame(0.f, 2.f * MAX_FRAME_TIME);
+		bool bounded = true;
+		for (unsigned i = 0; i < STEP_FRAMES && bounded; ++i)
+		{
+			unsigned steps = physics.step(frame(random));
+			bounded = steps <= max_steps && physics.get_alpha() >= 0.f && physics.get_alpha() < 1.f;
+		}
+		CHECK(bounded);
+	}
+
+	// true when no two constraints inside one batch of cons touch the same particle and the batches
+	// cover cons exactly. P is how many particles a constraint has, read through its p1 member.
+	// A constraint may name one particle twice, the sphere's poles have p1 == p2
+	template <typename T, unsigned P>
+	bool BatchesIndependent(const std::vector<T>& cons, const std::vector<unsigned>& batches, unsigned particles)
+	{
+		if (batches.empty() || batches.front() != 0 || batches.back() != cons.size())
+			return false;
+		// last constraint that touched each particle, batches are ascending ranges of cons
+		std::vector<unsigned> last(particles, ~0u);
+		for (unsigned c = 0; c + 1 < batches.size(); ++c)
+			for (unsigned j = batches[c]; j < batches[c + 1]; ++j)
+			{
+				const int* p = &cons[j].p1;
+				for (unsigned k = 0; k < P; ++k)
+				{
+					unsigned before = last[p[k]];
+					if (before != ~0u && before >= batches[c] && before != j)
+						return false;
+					last[p[k]] = j;
+				}
+			}
+		return true;
+	}
+
+	// every color batch of the cloth and of a softbody sphere can be split across threads
+	void TestConstraintColoring()
+	{
+		SoftBodyPhysics cloth(O_PLANE, glm::vec3(0.f), glm::vec3(6.f, 1.f, 10.f), P_DIMENSION);
+		SoftBodyPhysics sphere(O_SPHERE, glm::vec3(0.f), glm::vec3(1.f), MID_S_DIMENSION);
+		for (SoftBodyPhysics* body : { &cloth, &sphere })
+		{
+			unsigned particles = body->m_scaled_ver.size();
+			CHECK(!body->DistanceConstraints().empty());
+			CHECK((BatchesIndependent<constraints, 2>(body->DistanceConstraints(), body->DistanceBatches(), particles)));
+			CHECK((body->VolumeConstraints().empty()
+				|| BatchesIndependent<volume_constraints, 4>(body->VolumeConstraints(), body->VolumeBatches(), particles)));
+		}
+	}
+
+	// the batches split across TEST_THREADS threads have to end on the same bits as one thread
+	void TestThreadCountsMatch()
+	{
+		ThreadPool single(1);
+		ThreadPool::SetInstance(&single);
+		std::vector<uint64_t> one = SceneChecksums();
+		ThreadPool several(TEST_THREADS);
+		ThreadPool::SetInstance(&several);
+		std::vector<uint64_t> many = SceneChecksums();
+		ThreadPool::SetInstance(nullptr);
+		CHECK(!one.empty());
+		CHECK(one == many);
+	}
+
+	// every overlapping pair (i, j), i < j, by testing all of them
+	std::vector<std::pair<unsigned, unsigned>> BruteForcePairs(const std::vector<glm::vec3>& min, const std::vector<glm::vec3>& max)
+	{
+		std::vector<std::pair<unsigned, unsigned>> pairs;
+		for (unsigned i = 0; i < min.size(); ++i)
+			for (unsigned j = i + 1; j < min.size(); ++j)
+				if (glm::all(glm::lessThanEqual(min[i], max[j])) && glm::all(glm::lessThanEqual(min[j], max[i])))
+					pairs.push_back(std::make_pair(i, j));
+		return pairs;
+	}
+
+	// the spatial hash has to find exactly the pairs the O(n^2) loop finds
+	void TestBroadphaseMatchesBruteForce()
+	{
+		std::mt19937 random(17);
+		std::uniform_real_distribution<float> unit(0.f, 1.f);
+		auto vector = [&](float low, float high) {
+			return glm::vec3(low + (high - low) * unit(random), low + (high - low) * unit(random), low + (high - low) * unit(random));
+		};
+		Broadphase broadphase;
+		std::vector<std::pair<unsigned, unsigned>> pairs;
+		for (unsigned round = 0; round < BROADPHASE_ROUNDS; ++round)
+		{
+			std::vector<glm::vec3> min, max;
+			// small boxes on both sides of the origin
+			for (unsigned i = 0; i < 120; ++i)
+			{
+				min.push_back(vector(-8.f, 8.f));
+				max.push_back(min.back() + vector(0.2f, 1.f));
+			}
+			// larger than a cell, and a few covering more than BROADPHASE_MAX_CELLS that skip the grid
+			for (unsigned i = 0; i < 8; ++i)
+			{
+				min.push_back(vector(-8.f, 8.f));
+				max.push_back(min.back() + vector(2.f, 5.f));
+			}
+			for (unsigned i = 0; i < 2; ++i)
+			{
+				min.push_back(vector(-12.f, 0.f));
+				max.push_back(min.back() + vector(12.f, 20.f));
+			}
+			// the cell size is the average largest extent, boxes of exactly that size keep it. Each one
+			// is centered on a cell border and a second one touches its far face, which lies inside a cell
+			float cell = 0.f;
+			for (unsigned i = 0; i < min.size(); ++i)
+			{
+				glm::vec3 extent = max[i] - min[i];
+				cell += std::max(extent.x, std::max(extent.y, extent.z));
+			}
+			cell /= min.size();
+			for (unsigned i = 0; i < 10; ++i)
+			{
+				glm::vec3 border = glm::floor(vector(-6.f, 6.f)) * cell;
+				min.push_back(border - glm::vec3(0.5f * cell));
+				max.push_back(border + glm::vec3(0.5f * cell));
+				glm::vec3 touching = min.back();
+				int axis = static_cast<int>(random() % 3);
+				touching[axis] = max.back()[axis];
+				min.push_back(touching);
+				max.push_back(touching + glm::vec3(cell));
+			}
+
+			broadphase.FindPairs(min, max, pairs);
+			Check(pairs == BruteForcePairs(min, max), "pairs == BruteForcePairs(min, max)", __FILE__, __LINE__);
+		}
+	}
+
+	// a hidden window for its GL 4.3 context, null when none can be made or it can't run compute shaders
+	GLFWwindow* CreateComputeContext()
+	{
+		if (!glfwInit())
+			return nullptr;
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		GLFWwindow* window = glfwCreateWindow(64, 64, "Physics_Tests", NULL, NULL);
+		if (!window)
+		{
+			glfwTerminate();
+			return nullptr;
+		}
+		glfwMakeContextCurrent(window);
+		if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress) || !GpuSoftBody::Supported())
+		{
+			glfwDestroyWindow(window);
+			glfwTerminate();
+			return nullptr;
+		}
+		return window;
+	}
+
+	// steps the content of scene BACKEND_STEPS times, on the compute path if gpu, and leaves the
+	// particles in m_scaled_ver
+	bool RunBackend(unsigned scene, bool gpu, SceneContent& content)
+	{
+		BuildSceneContent(scene, content);
+		Physics physics;
+		for (auto rigid : content.rigid)
+			physics.push_object(rigid);
+		for (auto soft : content.softbody)
+			physics.push_object(soft);
+		bool moved = !gpu || physics.UseGpu(true);
+		for (unsigned i = 0; moved && i < BACKEND_STEPS; ++i)
+			physics.update(PHYSICS_STEP);
+		physics.UseGpu(false);
+		physics.clear_objects();
+		return moved;
+	}
+
+	void DeleteContent(SceneContent& content)
+	{
+		for (auto rigid : content.rigid)
+			delete rigid;
+		for (auto soft : content.softbody)
+			delete soft;
+	}
+
+	// the cloth scene stepped on both backends has to end up with the same particles.
+	// Needs a GL 4.3 context, Mesa's llvmpipe is enough; without one the test only says so
+	void TestGpuMatchesCpu()
+	{
+		// the objects get their GL buffers, which UseGpu uploads from
+		Object::headless = false;
+		GLFWwindow* window = CreateComputeContext();
+		if (!window)
+		{
+			Object::headless = true;
+			printf("  skipped: no GL 4.3 context for the compute path\n");
+			return;
+		}
+		SceneContent cpu, gpu;
+		CHECK(RunBackend(BACKEND_SCENE, false, cpu));
+		CHECK(RunBackend(BACKEND_SCENE, true, gpu));
+		CHECK(cpu.softbody.size() == 1 && gpu.softbody.size() == 1);
+		if (cpu.softbody.size() == 1 && gpu.softbody.size() == 1)
+		{
+			const ParticleArray& a = cpu.softbody[0]->m_scaled_ver;
+			const ParticleArray& b = gpu.softbody[0]->m_scaled_ver;
+			CHECK(a.size() == b.size());
+			float worst = 0.f;
+			for (unsigned i = 0; i < a.size() && i < b.size(); ++i)
+				worst = std::max(worst, glm::length(a.get(i) - b.get(i)));
+			if (worst > BACKEND_EPSILON)
+				printf("  worst particle difference %g\n", worst);
+			CHECK(worst <= BACKEND_EPSILON);
+		}
+		DeleteContent(cpu);
+		DeleteContent(gpu);
+		GpuSoftBody::ShutDown();
+		Object::headless = true;
+		glfwDestroyWindow(window);
+		glfwTerminate();
+	}
+
+	struct Test {
+		const char* name;
+		void (*run)();
+	};
+	const Test tests[] = {
+		{ "obj_loader.faces", TestObjFaces },
+		{ "obj_loader.negative_indices", TestObjNegativeIndices },
+		{ "obj_loader.missing_uv", TestObjMissingUv },
+		{ "obj_loader.malformed", TestObjMalformed },
+		{ "obj_loader.floats", TestObjFloats },
+		{ "object.mesh_cache_hit", TestMeshCacheHit },
+		{ "object.sphere_seam_normals", TestSphereSeamNormals },
+		{ "texture_cache.bc1", TestBC1 },
+		{ "texture_cache.bc4", TestBC4 },
+		{ "texture_cache.bc5", TestBC5 },
+		{ "texture_cache.bc7", TestBC7 },
+		{ "physics.step_accumulator", TestStepAccumulator },
+		{ "physics.broadphase_pairs", TestBroadphaseMatchesBruteForce },
+		{ "physics.tree_matches_linear_scan", TestTreeMatchesLinearScan },
+		{ "physics.constraint_coloring", TestConstraintColoring },
+		{ "physics.thread_counts_match", TestThreadCountsMatch },
+		{ "physics.simd_levels_match", TestSimdLevelsMatch },
+		{ "physics.gpu_matches_cpu", TestGpuMatchesCpu },
+	};
+
+	void PrintUsage()
+	{
+		printf("usage: Physics_Tests [--filter substring]\n");
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::string filter;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!strcmp(argv[i], "--filter") && i + 1 < argc)
+			filter = argv[++i];
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	// no GL context, objects only build their geometry
+	Object::headless = true;
+	unsigned run = 0, failed = 0;
+	for (const Test& test : tests)
+	{
+		if (!filter.empty() && std::string(test.name).find(filter) == std::string::npos)
+			continue;
+		unsigned before = failures;
+		test.run();
+		++run;
+		failed += failures != before;
+		printf("%-32s %s\n", test.name, failures != before ? "FAILED" : "ok");
+	}
+	printf("%u of %u tests passed\n", run - failed, run);
+	return failed ? 1 : 0;
+}